@@ -1,7 +1,7 @@
-// Copyright Epic Games, Inc. All Rights Reserved.
-
-#include "BeBoids.h"
-#include "Modules/ModuleManager.h"
-
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, BeBoids, "BeBoids" );
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BeBoids.h"
+#include "Modules/ModuleManager.h"
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, BeBoids, "BeBoids" );
  
\ No newline at end of file
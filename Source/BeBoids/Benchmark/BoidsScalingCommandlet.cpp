@@ -0,0 +1,172 @@
+#include "BoidsScalingCommandlet.h"
+#include "BeBoids/Entities/Manager/BoidsManager.h"
+#include "Engine/Engine.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	// Frame rate the flock is stepped at
+	constexpr float BenchmarkDeltaTime = 1.0f / 60.0f;
+
+	// Number of obstacle pillars on each axis of the obstacle grid
+	constexpr int32 NumObstaclesPerAxis = 6;
+
+	// Returns the value below which Percentile of the sorted samples fall
+	double GetPercentile(const TArray<double>& SortedSamples, double Percentile)
+	{
+		if (SortedSamples.Num() == 0)
+		{
+			return 0.0;
+		}
+
+		const int32 Index = FMath::Clamp(FMath::CeilToInt32(Percentile * SortedSamples.Num()) - 1, 0, SortedSamples.Num() - 1);
+		return SortedSamples[Index];
+	}
+
+	// Appends the mean, p95 and p99 of one phase to the CSV
+	void AppendPhase(FString& Csv, int32 NumBoids, bool bObstacles, const TCHAR* Phase, TArray<double>& Samples)
+	{
+		Samples.Sort();
+
+		double Mean = 0.0;
+		for (double Sample : Samples)
+		{
+			Mean += Sample;
+		}
+		Mean /= FMath::Max(Samples.Num(), 1);
+
+		Csv += FString::Printf(TEXT("%d,%d,%s,%.4f,%.4f,%.4f\n"), NumBoids, bObstacles ? 1 : 0, Phase,
+			Mean, GetPercentile(Samples, 0.95), GetPercentile(Samples, 0.99));
+	}
+}
+
+UBoidsScalingCommandlet::UBoidsScalingCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UBoidsScalingCommandlet::Main(const FString& Params)
+{
+	FString CountsString = TEXT("100,1000,10000,50000");
+	int32 NumFrames = 300;
+	int32 NumWarmupFrames = 30;
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / TEXT("BoidsScaling.csv");
+
+	FParse::Value(*Params, TEXT("counts="), CountsString);
+	FParse::Value(*Params, TEXT("frames="), NumFrames);
+	FParse::Value(*Params, TEXT("warmup="), NumWarmupFrames);
+	FParse::Value(*Params, TEXT("output="), OutputPath);
+	const bool bActors = FParse::Param(*Params, TEXT("actors"));
+
+	TArray<FString> Counts;
+	CountsString.ParseIntoArray(Counts, TEXT(","));
+
+	FString Csv = TEXT("boids,obstacles,phase,mean_ms,p95_ms,p99_ms\n");
+
+	for (const FString& Count : Counts)
+	{
+		const int32 NumBoids = FCString::Atoi(*Count);
+		if (NumBoids <= 0)
+		{
+			continue;
+		}
+
+		RunScenario(NumBoids, false, bActors, NumFrames, NumWarmupFrames, Csv);
+		RunScenario(NumBoids, true, bActors, NumFrames, NumWarmupFrames, Csv);
+	}
+
+	if (!FFileHelper::SaveStringToFile(Csv, *OutputPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Could not write the boids scaling results to %s."), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Boids scaling results written to %s."), *OutputPath);
+	return 0;
+}
+
+void UBoidsScalingCommandlet::RunScenario(int32 NumBoids, bool bObstacles, bool bActors, int32 NumFrames, int32 NumWarmupFrames, FString& Csv) const
+{
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("BoidsScalingWorld"));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	World->InitializeActorsForPlay(FURL());
+	World->GetWorldSettings()->NotifyBeginPlay();
+
+	// The spawn volume grows with the flock so the density matches the default 100 boids setup
+	const FVector SpawnVolume = FVector(500.0f, 500.0f, 200.0f) * FMath::Pow(NumBoids / 100.0f, 1.0f / 3.0f);
+
+	if (bObstacles)
+	{
+		UStaticMesh* CubeMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+		const FVector Spacing = SpawnVolume * 2.0f / NumObstaclesPerAxis;
+
+		for (int32 X = 0; X < NumObstaclesPerAxis; X++)
+		{
+			for (int32 Y = 0; Y < NumObstaclesPerAxis; Y++)
+			{
+				const FVector Location = -SpawnVolume + FVector((X + 0.5f) * Spacing.X, (Y + 0.5f) * Spacing.Y, 0.0f);
+				AStaticMeshActor* Obstacle = World->SpawnActor<AStaticMeshActor>(Location, FRotator::ZeroRotator);
+				// The world has already begun play, a static component would refuse the mesh change
+				Obstacle->SetMobility(EComponentMobility::Movable);
+				Obstacle->GetStaticMeshComponent()->SetStaticMesh(CubeMesh);
+				Obstacle->SetActorScale3D(FVector(1.0f, 1.0f, SpawnVolume.Z / 25.0f));
+			}
+		}
+	}
+
+	ABoidsManager* Manager = World->SpawnActorDeferred<ABoidsManager>(ABoidsManager::StaticClass(), FTransform::Identity);
+	Manager->BoidClass = ABoids::StaticClass();
+	Manager->m_NumBoids = NumBoids;
+	Manager->m_SpawnVolume = SpawnVolume;
+	Manager->m_bBatchSimulation = true;
+	Manager->m_bInstancedRendering = !bActors;
+	Manager->m_bCollisionFreeBoids = true;
+	Manager->FinishSpawning(FTransform::Identity);
+	Manager->SetPhaseTimings(true);
+
+	TArray<double> NeighborSearch;
+	TArray<double> Steering;
+	TArray<double> Avoidance;
+	TArray<double> WriteBack;
+	TArray<double> Total;
+
+	for (int32 Frame = 0; Frame < NumWarmupFrames + NumFrames; Frame++)
+	{
+		World->Tick(LEVELTICK_All, BenchmarkDeltaTime);
+		GFrameCounter++;
+
+		if (Frame < NumWarmupFrames)
+		{
+			continue;
+		}
+
+		const FBoidsFrameTimings& Timings = Manager->GetLastFrameTimings();
+		NeighborSearch.Add(Timings.NeighborSearchMs);
+		Steering.Add(Timings.SteeringMs);
+		Avoidance.Add(Timings.AvoidanceMs);
+		WriteBack.Add(Timings.WriteBackMs);
+		Total.Add(Timings.NeighborSearchMs + Timings.SteeringMs + Timings.AvoidanceMs + Timings.WriteBackMs);
+	}
+
+	AppendPhase(Csv, NumBoids, bObstacles, TEXT("neighbor_search"), NeighborSearch);
+	AppendPhase(Csv, NumBoids, bObstacles, TEXT("steering"), Steering);
+	AppendPhase(Csv, NumBoids, bObstacles, TEXT("avoidance"), Avoidance);
+	AppendPhase(Csv, NumBoids, bObstacles, TEXT("write_back"), WriteBack);
+	AppendPhase(Csv, NumBoids, bObstacles, TEXT("total"), Total);
+
+	UE_LOG(LogTemp, Display, TEXT("Stepped %d boids%s for %d frames."), Manager->GetNumBoids(), bObstacles ? TEXT(" with obstacles") : TEXT(""), NumFrames);
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "BoidsScalingCommandlet.generated.h"
+
+/**
+ * UBoidsScalingCommandlet measures how the flock frame time scales with the number of boids.
+ * It steps flocks of several sizes, with and without obstacles, in a headless world and
+ * writes the mean, p95 and p99 time of every phase to a CSV file.
+ *
+ * Usage: UnrealEditor-Cmd BeBoids.uproject -run=BoidsScaling -nullrhi -unattended
+ *        [-counts=100,1000,10000,50000] [-frames=300] [-warmup=30] [-actors] [-output=Path.csv]
+ */
+UCLASS()
+class BEBOIDS_API UBoidsScalingCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	// Constructor
+	UBoidsScalingCommandlet();
+
+	// Runs every scenario and writes the CSV results
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	// Steps one flock for NumFrames frames and appends one CSV row per phase
+	void RunScenario(int32 NumBoids, bool bObstacles, bool bActors, int32 NumFrames, int32 NumWarmupFrames, FString& Csv) const;
+};
@@ -1,427 +1,285 @@
-#include "Boids.h"
-#include "Kismet/GameplayStatics.h"
-
-ABoids::ABoids()
-{
-	PrimaryActorTick.bCanEverTick = true;
-
-	CollisionComponent = CreateDefaultSubobject<USphereComponent>(TEXT("CollisionComponent"));
-	RootComponent = CollisionComponent;
-    
-	CollisionComponent->SetSphereRadius(100.0f);
-    
-	CollisionComponent->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-	CollisionComponent->SetCollisionObjectType(ECC_Pawn);
-	CollisionComponent->SetCollisionResponseToAllChannels(ECR_Ignore);
-	CollisionComponent->SetCollisionResponseToChannel(ECC_Pawn, ECR_Overlap);
-	CollisionComponent->SetGenerateOverlapEvents(true);
-
-	BoidsMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("BoidsMesh"));
-	BoidsMesh->SetupAttachment(CollisionComponent);
-
-	static ConstructorHelpers::FObjectFinder<UStaticMesh> CubeMeshAsset(TEXT("/Engine/BasicShapes/Cube"));
-	if (CubeMeshAsset.Succeeded())
-	{
-		BoidsMesh->SetStaticMesh(CubeMeshAsset.Object);
-		BoidsMesh->SetRelativeScale3D(FVector(0.5f, 0.5f, 0.5f));
-        
-		BoidsMesh->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-		BoidsMesh->SetCollisionObjectType(ECC_WorldDynamic);
-		BoidsMesh->SetCollisionResponseToChannel(ECC_WorldStatic, ECR_Block);
-	}
-
-	BoidsMesh->SetSimulatePhysics(false);
-    
-	OnActorBeginOverlap.AddDynamic(this, &ABoids::OnBeginOverlap);
-	OnActorEndOverlap.AddDynamic(this, &ABoids::OnEndOverlap);
-	
-	CollisionComponent->SetCollisionObjectType(ECC_GameTraceChannel1);
-	CollisionComponent->SetCollisionResponseToChannel(ECC_GameTraceChannel1, ECR_Overlap);
-}
-
-void ABoids::BeginPlay()
-{
-	Super::BeginPlay();
-}
-
-void ABoids::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
-
-	FindNeighbors();
-	ApplySeparation();
-	ApplyObstacleAvoidance();
-	ApplyAlignment();
-	//ApplyCohesion();
-	//ApplyWander();
-    
-	m_Velocity = m_Velocity.GetClampedToSize(m_MinSpeed, m_MaxSpeed);
-	AddActorWorldOffset(m_Velocity * DeltaTime);
-    
-	if (!m_Velocity.IsNearlyZero())
-	{
-		SetActorRotation(m_Velocity.Rotation());
-	}
-
-	FVector SteeringForce = CalculateSteeringForces();
-	m_Velocity += SteeringForce * DeltaTime;
-	m_Velocity = m_Velocity.GetClampedToSize(m_MinSpeed, m_MaxSpeed);
-	AddActorWorldOffset(m_Velocity * DeltaTime);
-	SetActorRotation(m_Velocity.Rotation());
-}
-
-void ABoids::ApplyObstacleAvoidance()
-{
-    FVector Direction = m_Velocity.GetSafeNormal();
-    float MaxDistance = 200.0f;
-    bool ObstacleDetected = false;
-    
-    TArray<FVector> RayDirections;
-    RayDirections.Add(GetActorForwardVector());
-    
-    FRotator SlightLeftRot(0, -15, 0);
-    FRotator SlightRightRot(0, 15, 0);
-    FRotator MoreLeftRot(0, -30, 0);
-    FRotator MoreRightRot(0, 30, 0);
-    
-    RayDirections.Add(SlightLeftRot.RotateVector(GetActorForwardVector()));
-    RayDirections.Add(SlightRightRot.RotateVector(GetActorForwardVector()));
-    RayDirections.Add(MoreLeftRot.RotateVector(GetActorForwardVector()));
-    RayDirections.Add(MoreRightRot.RotateVector(GetActorForwardVector()));
-    
-    for (const FVector& RayDir : RayDirections)
-    {
-        FHitResult HitResult;
-        FCollisionQueryParams CollisionParams;
-        CollisionParams.AddIgnoredActor(this);
-        
-        FVector Start = GetActorLocation();
-        FVector End = Start + RayDir * MaxDistance;
-        
-        if (GetWorld()->LineTraceSingleByChannel(HitResult, Start, End, ECC_Visibility, CollisionParams))
-        {
-            FVector AvoidanceVector = Start - HitResult.ImpactPoint;
-            float Distance = AvoidanceVector.Size();
-            
-            float Ratio = 1.0f - (Distance / MaxDistance);
-            
-            Direction += AvoidanceVector.GetSafeNormal() * Ratio * m_AvoidanceWeight;
-            ObstacleDetected = true;
-            
-            /*if (GetWorld()->IsPlayInEditor())
-            {
-                DrawDebugLine(GetWorld(), Start, HitResult.ImpactPoint, FColor::Red, false, -1.0f, 0, 2.0f);
-            }*/
-        }
-    }
-    
-    if (ObstacleDetected && !Direction.IsNearlyZero())
-    {
-        Direction.Normalize();
-        
-        float CurrentSpeed = m_Velocity.Size();
-        m_Velocity = Direction * CurrentSpeed;
-    }
-}
-
-void ABoids::ApplySeparation()
-{
-	FVector Direction = m_Velocity.GetSafeNormal();
-	float MaxDistance = 100.0f;
-    
-	for (ABoids* Neighbor : m_Neighbors)
-	{
-		FVector SeparationVector = GetActorLocation() - Neighbor->GetActorLocation();
-		float Distance = SeparationVector.Size();
-        
-		if (Distance > 0.0f && Distance < MaxDistance)
-		{
-			float Ratio = Distance / MaxDistance;
-			Direction += SeparationVector * Ratio * m_SeparationWeight;
-		}
-	}
-    
-	if (!Direction.IsNearlyZero())
-	{
-		Direction.Normalize();
-	}
-    
-	float CurrentSpeed = m_Velocity.Size();
-	m_Velocity = Direction * CurrentSpeed;
-}
-
-void ABoids::ApplyAlignment()
-{
-	FVector Direction = m_Velocity.GetSafeNormal();
-    
-	if (m_Neighbors.Num() > 0)
-	{
-		FVector AverageDirection = FVector::ZeroVector;
-		for (ABoids* Neighbor : m_Neighbors)
-		{
-			AverageDirection += Neighbor->m_Velocity.GetSafeNormal();
-		}
-		AverageDirection /= m_Neighbors.Num();
-        
-		Direction += AverageDirection * m_AlignmentWeight;
-		Direction.Normalize();
-        
-		float CurrentSpeed = m_Velocity.Size();
-		m_Velocity = Direction * CurrentSpeed;
-	}
-}
-
-void ABoids::ApplyCohesion()
-{
-    if (m_Neighbors.Num() == 0)
-        return;
-    
-    FVector Direction = m_Velocity.GetSafeNormal();
-    
-    FVector CenterOfMass = FVector::ZeroVector;
-    for (ABoids* Neighbor : m_Neighbors)
-    {
-        CenterOfMass += Neighbor->GetActorLocation();
-    }
-    CenterOfMass /= m_Neighbors.Num();
-    
-    FVector ToCenterVector = CenterOfMass - GetActorLocation();
-    float Distance = ToCenterVector.Size();
-    
-    float MaxDistance = 300.0f;
-    
-    if (Distance > 0.0f && Distance < MaxDistance)
-    {
-        float Ratio = Distance / MaxDistance;
-        
-        Direction += ToCenterVector.GetSafeNormal() * Ratio * m_CohesionWeight;
-        
-        if (!Direction.IsNearlyZero())
-        {
-            Direction.Normalize();
-        }
-        
-        float CurrentSpeed = m_Velocity.Size();
-        m_Velocity = Direction * CurrentSpeed;
-    }
-    
-    /*if (GetWorld()->IsPlayInEditor())
-    {
-        DrawDebugLine(GetWorld(), GetActorLocation(), CenterOfMass, 
-                      FColor::Blue, false, -1.0f, 0, 1.0f);
-        DrawDebugSphere(GetWorld(), CenterOfMass, 10.0f, 8, 
-                      FColor::Blue, false, -1.0f, 0, 1.0f);
-    }*/
-}
-
-void ABoids::ApplyWander()
-{
-    FVector Direction = m_Velocity.GetSafeNormal();
-    
-    float WanderStrength = 0.1f;
-    float WanderRate = 0.3f;
-    
-    if (FMath::FRand() < WanderRate)
-    {
-        float RandomAngleYaw = FMath::RandRange(-20.0f, 20.0f);
-        float RandomAnglePitch = FMath::RandRange(-10.0f, 10.0f);
-        
-        FRotator RandomRotation(RandomAnglePitch, RandomAngleYaw, 0.0f);
-        
-        FVector WanderDirection = RandomRotation.RotateVector(Direction);
-        
-        Direction += WanderDirection * WanderStrength * m_WanderWeight;
-        
-        if (!Direction.IsNearlyZero())
-        {
-            Direction.Normalize();
-        }
-        
-        float CurrentSpeed = m_Velocity.Size();
-        m_Velocity = Direction * CurrentSpeed;
-        
-        /*if (GetWorld()->IsPlayInEditor())
-        {
-            DrawDebugLine(GetWorld(), GetActorLocation(), 
-                          GetActorLocation() + WanderDirection * 50.0f, 
-                          FColor::Yellow, false, 0.2f, 0, 1.0f);
-        }*/
-    }
-}
-
-void ABoids::FindNeighbors()
-{
-	m_Neighbors.Empty();
-
-	TArray<AActor*> AllBoids;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), ABoids::StaticClass(), AllBoids);
-
-	for (AActor* Boid : AllBoids)
-	{
-		ABoids* BoidRef = Cast<ABoids>(Boid);
-
-		if (BoidRef != this)
-		{
-			float Distance = FVector::Dist(GetActorLocation(), BoidRef->GetActorLocation());
-
-			if (Distance <= m_PerceptionRadius)
-			{
-				m_Neighbors.Add(BoidRef);
-			}
-		}
-	}
-}
-
-FVector ABoids::CalculateSteeringForces()
-{
-	FVector SeparationForce = CalculateSeparation();
-	FVector AlignmentForce = CalculateAlignment();
-	FVector CohesionForce = CalculateCohesion();
-	FVector AvoidanceForce = CalculateObstacleAvoidance();
-	FVector WanderForce = CalculateWanderForce();
-    
-	return SeparationForce * m_SeparationWeight + 
-		   AlignmentForce * m_AlignmentWeight + 
-		   CohesionForce * m_CohesionWeight + 
-		   AvoidanceForce * m_AvoidanceWeight + WanderForce * m_WanderWeight;
-}
-
-FVector ABoids::CalculateSeparation()
-{
-	FVector SeparationDirection = FVector::ZeroVector;
-	float MaxDistance = m_PerceptionRadius;
-    
-	if (m_Neighbors.Num() == 0)
-		return SeparationDirection;
-    
-	for (ABoids* Neighbor : m_Neighbors)
-	{
-		FVector DifferenceVector = GetActorLocation() - Neighbor->GetActorLocation();
-		float Distance = DifferenceVector.Size();
-        
-		if (Distance > 0.0f && Distance < MaxDistance)
-		{
-			float Ratio = Distance / MaxDistance;
-			SeparationDirection += DifferenceVector * Ratio;
-		}
-	}
-    
-	if (!SeparationDirection.IsNearlyZero())
-	{
-		SeparationDirection.Normalize();
-	}
-    
-	return SeparationDirection;
-}
-
-FVector ABoids::CalculateAlignment()
-{
-	FVector AlignmentForce = FVector::ZeroVector;
-
-	for (ABoids* Neighbor : m_Neighbors)
-	{
-		AlignmentForce += Neighbor->m_Velocity;
-	}
-
-	if (m_Neighbors.Num() > 0)
-	{
-		AlignmentForce /= m_Neighbors.Num();
-		AlignmentForce -= m_Velocity;
-	}
-
-	return AlignmentForce;
-}
-
-FVector ABoids::CalculateCohesion()
-{
-	FVector CohesionForce = FVector::ZeroVector;
-
-	for (ABoids* Neighbor : m_Neighbors)
-	{
-		CohesionForce += Neighbor->GetActorLocation();
-	}
-
-	if (m_Neighbors.Num() > 0)
-	{
-		CohesionForce /= m_Neighbors.Num();
-		CohesionForce -= GetActorLocation();
-	}
-
-	return CohesionForce;
-}
-
-FVector ABoids::CalculateObstacleAvoidance() const
-{
-    FVector AvoidanceDirection = FVector::ZeroVector;
-    float MaxDistance = 200.0f;
-    
-    TArray<FVector> RayDirections;
-    
-    RayDirections.Add(GetActorForwardVector());
-    
-    FRotator LeftRot(0, -30, 0);
-    FRotator RightRot(0, 30, 0);
-    RayDirections.Add(LeftRot.RotateVector(GetActorForwardVector()));
-    RayDirections.Add(RightRot.RotateVector(GetActorForwardVector()));
-    
-    for (const FVector& RayDir : RayDirections)
-    {
-        FHitResult HitResult;
-        FCollisionQueryParams CollisionParams;
-        CollisionParams.AddIgnoredActor(this);
-        
-        FVector Start = GetActorLocation();
-        FVector End = Start + RayDir * MaxDistance;
-        
-        bool bHit = GetWorld()->LineTraceSingleByChannel(HitResult, Start, End, ECC_Visibility, CollisionParams);
-        
-        if (bHit)
-        {
-            FVector DifferenceVector = Start - HitResult.ImpactPoint;
-            float Distance = DifferenceVector.Size();
-            
-            float Ratio = 1.0f - (Distance / MaxDistance);
-            
-            AvoidanceDirection += DifferenceVector.GetSafeNormal() * Ratio * Ratio;
-            
-            /*if (GetWorld()->IsPlayInEditor())
-            {
-                DrawDebugLine(GetWorld(), Start, HitResult.ImpactPoint, FColor::Red, false, -1.0f, 0, 2.0f);
-                DrawDebugSphere(GetWorld(), HitResult.ImpactPoint, 10.0f, 8, FColor::Orange, false, -1.0f, 0, 1.0f);
-            }*/
-        }
-    }
-    
-    if (!AvoidanceDirection.IsNearlyZero())
-    {
-        AvoidanceDirection.Normalize();
-    }
-    
-    return AvoidanceDirection;
-}
-
-FVector ABoids::CalculateWanderForce()
-{
-	float RandomAngle = FMath::RandRange(-30.0f, 30.0f);
-	FRotator Rotation = FRotator(0, RandomAngle, 0);
-	FVector WanderDirection = Rotation.RotateVector(m_Velocity.GetSafeNormal());
-    
-	return WanderDirection * 0.1f;
-}
-
-void ABoids::OnBeginOverlap(AActor* OverlappedActor, AActor* OtherActor)
-{
-	ABoids* OtherBoids = Cast<ABoids>(OtherActor);
-	if (OtherBoids && OtherBoids != this)
-	{
-		m_Neighbors.AddUnique(OtherBoids);
-	}
-}
-
-void ABoids::OnEndOverlap(AActor* OverlappedActor, AActor* OtherActor)
-{
-	if (ABoids* OtherBoids = Cast<ABoids>(OtherActor))
-	{
-		m_Neighbors.Remove(OtherBoids);
-	}
+#include "Boids.h"
+#include "BeBoids/Entities/Manager/BoidsManager.h"
+#include "BoidsRules.h"
+#include "BoidsStats.h"
+#include "Kismet/GameplayStatics.h"
+
+ABoids::ABoids()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	CollisionComponent = CreateDefaultSubobject<USphereComponent>(TEXT("CollisionComponent"));
+	RootComponent = CollisionComponent;
+    
+	CollisionComponent->SetSphereRadius(100.0f);
+    
+	CollisionComponent->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	CollisionComponent->SetCollisionObjectType(ECC_Pawn);
+	CollisionComponent->SetCollisionResponseToAllChannels(ECR_Ignore);
+	CollisionComponent->SetCollisionResponseToChannel(ECC_Pawn, ECR_Overlap);
+	CollisionComponent->SetGenerateOverlapEvents(true);
+
+	BoidsMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("BoidsMesh"));
+	BoidsMesh->SetupAttachment(CollisionComponent);
+
+	static ConstructorHelpers::FObjectFinder<UStaticMesh> CubeMeshAsset(TEXT("/Engine/BasicShapes/Cube"));
+	if (CubeMeshAsset.Succeeded())
+	{
+		BoidsMesh->SetStaticMesh(CubeMeshAsset.Object);
+		BoidsMesh->SetRelativeScale3D(FVector(0.5f, 0.5f, 0.5f));
+        
+		BoidsMesh->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+		BoidsMesh->SetCollisionObjectType(ECC_WorldDynamic);
+		BoidsMesh->SetCollisionResponseToChannel(ECC_WorldStatic, ECR_Block);
+	}
+
+	BoidsMesh->SetSimulatePhysics(false);
+    
+	OnActorBeginOverlap.AddDynamic(this, &ABoids::OnBeginOverlap);
+	OnActorEndOverlap.AddDynamic(this, &ABoids::OnEndOverlap);
+	
+	CollisionComponent->SetCollisionObjectType(ECC_GameTraceChannel1);
+	CollisionComponent->SetCollisionResponseToChannel(ECC_GameTraceChannel1, ECR_Overlap);
+}
+
+void ABoids::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// A manager hands its seed over once the boid is spawned, a boid placed alone seeds from its name so the level replays the same way
+	if (m_Seed == 0)
+	{
+		m_Seed = GetTypeHash(GetFName());
+	}
+
+	// A zero velocity stays clamped to zero, start moving in a direction drawn from a stream no tick uses
+	if (m_Velocity.IsNearlyZero())
+	{
+		FBoidsRandom Random(m_Seed, m_BoidIndex, MAX_uint32);
+		m_Velocity = Random.GetUnitVector() * m_MinSpeed;
+	}
+}
+
+void ABoids::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	if (m_bCollisionFree)
+	{
+		SetCollisionFree();
+	}
+}
+
+void ABoids::SetCollisionFree()
+{
+	m_bCollisionFree = true;
+
+	// Neither the sphere nor the mesh take part in the broadphase anymore
+	CollisionComponent->SetGenerateOverlapEvents(false);
+	CollisionComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	BoidsMesh->SetGenerateOverlapEvents(false);
+	BoidsMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+	OnActorBeginOverlap.RemoveDynamic(this, &ABoids::OnBeginOverlap);
+	OnActorEndOverlap.RemoveDynamic(this, &ABoids::OnEndOverlap);
+	m_Neighbors.Reset();
+}
+
+bool ABoids::HasBlockingCollision() const
+{
+	const UPrimitiveComponent* Root = Cast<UPrimitiveComponent>(GetRootComponent());
+	if (m_bCollisionFree || !Root || Root->GetCollisionEnabled() == ECollisionEnabled::NoCollision)
+	{
+		return false;
+	}
+
+	for (const uint8 Response : Root->GetCollisionResponseToChannels().EnumArray)
+	{
+		if (Response == ECR_Block)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void ABoids::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const FVector Location = GetActorLocation();
+	{
+		BOIDS_SCOPE_CYCLE_COUNTER(STAT_BoidsFindNeighbors);
+		FindNeighbors();
+
+		// Neighbors go through the same kernel and rules as the manager batch simulation
+		m_NeighborBuffer.Reset();
+		for (const ABoids* Neighbor : m_Neighbors)
+		{
+			m_NeighborBuffer.Add(Neighbor->GetActorLocation() - Location, Neighbor->m_Velocity);
+		}
+	}
+
+	INC_DWORD_STAT(STAT_BoidsNum);
+	INC_QWORD_STAT_BY(STAT_BoidsNeighbors, m_NeighborBuffer.Num);
+
+	const FBoidsAvoidance Avoidance = GatherObstacleAvoidance();
+
+	FVector NewLocation = Location;
+	{
+		BOIDS_SCOPE_CYCLE_COUNTER(STAT_BoidsSteering);
+		const FBoidsSteeringSums Sums = FBoidsRules::GatherSums(m_NeighborBuffer, GetSettings());
+		FBoidsRandom Random(m_Seed, m_BoidIndex, m_StepCount++);
+		FBoidsRules::Integrate(GetSettings(), Sums, Avoidance, Random, DeltaTime, NewLocation, m_Velocity);
+	}
+
+	BOIDS_SCOPE_CYCLE_COUNTER(STAT_BoidsMove);
+	SetActorLocationAndRotation(NewLocation, m_Velocity.Rotation());
+}
+
+FBoidsAvoidance ABoids::GatherObstacleAvoidance() const
+{
+    BOIDS_SCOPE_CYCLE_COUNTER(STAT_BoidsObstacleAvoidance);
+
+    FBoidsAvoidance Avoidance;
+    
+    const FVector Start = GetActorLocation();
+
+    // The manager field replaces the rays, inside its volume a boid never queries the scene
+    const FBoidsDistanceField* DistanceField = m_Manager ? m_Manager->GetDistanceField() : nullptr;
+    float ObstacleDistance = 0.0f;
+    FVector ObstacleGradient = FVector::ZeroVector;
+    if (DistanceField && DistanceField->Sample(Start, ObstacleDistance, ObstacleGradient))
+    {
+        Avoidance.AddFieldSample(ObstacleDistance, ObstacleGradient, m_AvoidanceWeight);
+        Avoidance.Finalize();
+        return Avoidance;
+    }
+
+    INC_DWORD_STAT_BY(STAT_BoidsTracesIssued, FBoidsAvoidance::NumRays);
+
+    const FVector Forward = GetActorForwardVector();
+    
+    FCollisionQueryParams CollisionParams;
+    CollisionParams.AddIgnoredActor(this);
+    
+    // Every direction is cast once, the hits feed both the steering and the avoidance force
+    for (int32 RayIndex = 0; RayIndex < FBoidsAvoidance::NumRays; RayIndex++)
+    {
+        FHitResult HitResult;
+        const FVector RayDir = FRotator(0.0f, FBoidsAvoidance::RayYaws[RayIndex], 0.0f).RotateVector(Forward);
+        const FVector End = Start + RayDir * FBoidsAvoidance::RayLength;
+        
+        if (GetWorld()->LineTraceSingleByChannel(HitResult, Start, End, ECC_Visibility, CollisionParams))
+        {
+            Avoidance.AddHit(RayIndex, Start, HitResult.ImpactPoint, m_AvoidanceWeight);
+            
+            /*if (GetWorld()->IsPlayInEditor())
+            {
+                DrawDebugLine(GetWorld(), Start, HitResult.ImpactPoint, FColor::Red, false, -1.0f, 0, 2.0f);
+            }*/
+        }
+    }
+    
+    Avoidance.Finalize();
+    return Avoidance;
+}
+
+void ABoids::SetManager(ABoidsManager* Manager, int32 BoidIndex)
+{
+	m_Manager = Manager;
+	m_BoidIndex = BoidIndex;
+
+	// The manager rebuilds the spatial grid before any of its boids tick
+	if (m_Manager)
+	{
+		AddTickPrerequisiteActor(m_Manager);
+	}
+}
+
+void ABoids::SetInitialState(const FVector& Velocity, uint32 Seed)
+{
+	m_Velocity = Velocity;
+	m_Seed = Seed;
+	m_StepCount = 0;
+}
+
+FBoidsSettings ABoids::GetSettings() const
+{
+	FBoidsSettings Settings;
+	Settings.MaxSpeed = m_MaxSpeed;
+	Settings.MinSpeed = m_MinSpeed;
+	Settings.PerceptionRadius = m_PerceptionRadius;
+	Settings.AlignmentWeight = m_AlignmentWeight;
+	Settings.CohesionWeight = m_CohesionWeight;
+	Settings.SeparationWeight = m_SeparationWeight;
+	Settings.SeparationRadius = m_SeparationRadius;
+	Settings.TopologicalNeighbors = m_TopologicalNeighbors;
+	Settings.FarFieldRadius = m_FarFieldRadius;
+	Settings.AvoidanceWeight = m_AvoidanceWeight;
+	Settings.WanderWeight = m_WanderWeight;
+	return Settings;
+}
+
+void ABoids::FindNeighbors()
+{
+	m_Neighbors.Reset();
+
+	if (m_Manager)
+	{
+		m_Manager->FindNeighbors(m_BoidIndex, GetActorLocation(), m_PerceptionRadius, m_TopologicalNeighbors, m_Neighbors);
+		return;
+	}
+
+	TArray<AActor*> AllBoids;
+	UGameplayStatics::GetAllActorsOfClass(GetWorld(), ABoids::StaticClass(), AllBoids);
+
+	FBoidsNearestNeighbors Nearest;
+	Nearest.Reset(m_TopologicalNeighbors);
+
+	for (int32 i = 0; i < AllBoids.Num(); i++)
+	{
+		ABoids* BoidRef = Cast<ABoids>(AllBoids[i]);
+
+		if (BoidRef != this)
+		{
+			float Distance = FVector::Dist(GetActorLocation(), BoidRef->GetActorLocation());
+
+			if (Distance <= m_PerceptionRadius)
+			{
+				// In topological mode only the closest boids are kept, in a buffer that never grows
+				if (m_TopologicalNeighbors > 0)
+				{
+					Nearest.Offer(i, FMath::Square(Distance));
+				}
+				else
+				{
+					m_Neighbors.Add(BoidRef);
+				}
+			}
+		}
+	}
+
+	for (const FBoidsNearestNeighbors::FEntry& Entry : Nearest.Entries)
+	{
+		m_Neighbors.Add(Cast<ABoids>(AllBoids[Entry.Index]));
+	}
+}
+
+void ABoids::OnBeginOverlap(AActor* OverlappedActor, AActor* OtherActor)
+{
+	ABoids* OtherBoids = Cast<ABoids>(OtherActor);
+	if (OtherBoids && OtherBoids != this)
+	{
+		m_Neighbors.AddUnique(OtherBoids);
+	}
+}
+
+void ABoids::OnEndOverlap(AActor* OverlappedActor, AActor* OtherActor)
+{
+	if (ABoids* OtherBoids = Cast<ABoids>(OtherActor))
+	{
+		m_Neighbors.Remove(OtherBoids);
+	}
 }
\ No newline at end of file
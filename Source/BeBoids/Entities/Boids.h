@@ -1,118 +1,141 @@
-#pragma once
-
-#include "CoreMinimal.h"
-#include "Components/SphereComponent.h"
-#include "GameFramework/Actor.h"
-#include "Boids.generated.h"
-
-/**
- * ABoids class represents a boid entity in the simulation.
- * It inherits from AActor and contains components and methods
- * to handle boid behaviors such as separation, alignment, cohesion,
- * obstacle avoidance, and wandering.
- */
-UCLASS()
-class BEBOIDS_API ABoids : public AActor
-{
-	GENERATED_BODY()
-
-public:
-	// Constructor
-	ABoids();
-
-	// Mesh component for the boid
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category=Mesh)
-	UStaticMeshComponent* BoidsMesh;
-
-	// Collision component for the boid
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category=Collision)
-	USphereComponent* CollisionComponent;
-
-protected:
-	// Called when the game starts or when spawned
-	virtual void BeginPlay() override;
-
-public:
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
-
-	// Finds neighboring boids within a certain radius
-	UFUNCTION()
-	void FindNeighbors();
-
-	// Called when another actor begins to overlap with this actor
-	UFUNCTION()
-	void OnBeginOverlap(AActor* OverlappedActor, AActor* OtherActor);
-
-	// Called when another actor ends overlap with this actor
-	UFUNCTION()
-	void OnEndOverlap(AActor* OverlappedActor, AActor* OtherActor);
-
-	// Array of neighboring boids
-	UPROPERTY()
-	TArray<ABoids*> m_Neighbors;
-
-private:
-	// Applies separation behavior to the boid
-	void ApplySeparation();
-
-	// Applies obstacle avoidance behavior to the boid
-	void ApplyObstacleAvoidance();
-
-	// Applies alignment behavior to the boid
-	void ApplyAlignment();
-
-	// Applies cohesion behavior to the boid
-	void ApplyCohesion();
-
-	// Applies wandering behavior to the boid
-	void ApplyWander();
-
-	// Calculates the wander force for the boid
-	FVector CalculateWanderForce();
-
-	// Calculates the steering forces for the boid
-	FVector CalculateSteeringForces();
-
-	// Calculates the separation force for the boid
-	FVector CalculateSeparation();
-
-	// Calculates the alignment force for the boid
-	FVector CalculateAlignment();
-
-	// Calculates the cohesion force for the boid
-	FVector CalculateCohesion();
-
-	// Calculates the obstacle avoidance force for the boid
-	FVector CalculateObstacleAvoidance() const;
-
-	// Current velocity of the boid
-	FVector m_Velocity;
-
-	// Maximum speed of the boid
-	float m_MaxSpeed = 500.0f;
-
-	// Minimum speed of the boid
-	float m_MinSpeed = 200.0f;
-
-	// Perception radius for detecting neighbors
-	float m_PerceptionRadius = 500.0f;
-
-	// Weight for alignment behavior
-	float m_AlignmentWeight = 1.0f;
-
-	// Weight for cohesion behavior
-	float m_CohesionWeight = 1.0f;
-
-	// Weight for separation behavior
-	float m_SeparationWeight = 1.0f;
-
-	// Radius for separation behavior
-	float m_SeparationRadius = 150.0f;
-
-	// Weight for obstacle avoidance behavior
-	float m_AvoidanceWeight = 1.0f;
-
-	// Weight for wandering behavior
-	FVector m_WanderWeight;
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SphereComponent.h"
+#include "GameFramework/Actor.h"
+#include "BoidsFlockTypes.h"
+#include "BoidsSteeringKernel.h"
+#include "Boids.generated.h"
+
+class ABoidsManager;
+
+/**
+ * ABoids class represents a boid entity in the simulation.
+ * It inherits from AActor and adapts the BoidsCore flocking rules
+ * (separation, alignment, cohesion, obstacle avoidance and wandering)
+ * to an actor ticking on its own.
+ */
+UCLASS()
+class BEBOIDS_API ABoids : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	// Constructor
+	ABoids();
+
+	// Mesh component for the boid
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category=Mesh)
+	UStaticMeshComponent* BoidsMesh;
+
+	// Collision component for the boid
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category=Collision)
+	USphereComponent* CollisionComponent;
+
+	// Boid without physics body or overlap bookkeeping, neighbors only come from the manager spatial grid
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Collision)
+	bool m_bCollisionFree = false;
+
+	// Number of nearest neighbors the boid reacts to, around 7 keeps a dense flock cheap, zero reacts to every neighbor within the perception radius
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Flocking, meta = (ClampMin = "0", ClampMax = "16"))
+	int32 m_TopologicalNeighbors = 0;
+
+	// Distance beyond which the batch simulation reads neighbors from spatial cell sums, lets the perception radius grow at a near constant cost, zero reads every neighbor
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Flocking, meta = (ClampMin = "0.0", Units = "cm"))
+	float m_FarFieldRadius = 0.0f;
+
+protected:
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+
+	// Called once the components are initialized, before the first overlap update
+	virtual void PostInitializeComponents() override;
+
+public:
+	// Called every frame
+	virtual void Tick(float DeltaTime) override;
+
+	// Finds neighboring boids within a certain radius
+	UFUNCTION()
+	void FindNeighbors();
+
+	// Called when another actor begins to overlap with this actor
+	UFUNCTION()
+	void OnBeginOverlap(AActor* OverlappedActor, AActor* OtherActor);
+
+	// Called when another actor ends overlap with this actor
+	UFUNCTION()
+	void OnEndOverlap(AActor* OverlappedActor, AActor* OtherActor);
+
+	// Array of neighboring boids
+	UPROPERTY()
+	TArray<ABoids*> m_Neighbors;
+
+	// Removes the physics bodies and overlap events of the boid
+	void SetCollisionFree();
+
+	// Whether the root collision blocks any channel, the only case where a spawn location gets adjusted
+	bool HasBlockingCollision() const;
+
+	// Registers the manager owning this boid and the boid index in its flock
+	void SetManager(ABoidsManager* Manager, int32 BoidIndex);
+
+	// Sets the starting velocity and the seed of the wander random streams, for reproducible runs
+	void SetInitialState(const FVector& Velocity, uint32 Seed);
+
+	// Perception radius for detecting neighbors
+	float GetPerceptionRadius() const { return m_PerceptionRadius; }
+
+	// Steering parameters of this boid, used by the manager batch simulation
+	FBoidsSettings GetSettings() const;
+
+private:
+	// Casts the obstacle avoidance rays from the boid heading
+	FBoidsAvoidance GatherObstacleAvoidance() const;
+
+	// Manager owning the spatial grid used for neighbor queries
+	UPROPERTY()
+	ABoidsManager* m_Manager = nullptr;
+
+	// Index of this boid in the manager flock
+	int32 m_BoidIndex = INDEX_NONE;
+
+	// Current velocity of the boid
+	FVector m_Velocity;
+
+	// Maximum speed of the boid
+	float m_MaxSpeed = 500.0f;
+
+	// Minimum speed of the boid
+	float m_MinSpeed = 200.0f;
+
+	// Perception radius for detecting neighbors
+	float m_PerceptionRadius = 500.0f;
+
+	// Weight for alignment behavior
+	float m_AlignmentWeight = 1.0f;
+
+	// Weight for cohesion behavior
+	float m_CohesionWeight = 1.0f;
+
+	// Weight for separation behavior
+	float m_SeparationWeight = 1.0f;
+
+	// Radius for separation behavior
+	float m_SeparationRadius = 150.0f;
+
+	// Weight for obstacle avoidance behavior
+	float m_AvoidanceWeight = 1.0f;
+
+	// Weight for wandering behavior
+	FVector m_WanderWeight;
+
+	// Neighbors of the boid as structure of arrays for the steering kernel
+	FBoidsNeighborBuffer m_NeighborBuffer;
+
+	// Seed of the random streams used by the wander rules
+	uint32 m_Seed = 0;
+
+	// Number of ticks run so far, keys the random stream of each tick
+	uint32 m_StepCount = 0;
 };
\ No newline at end of file
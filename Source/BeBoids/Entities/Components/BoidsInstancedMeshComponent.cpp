@@ -0,0 +1,36 @@
+#include "BoidsInstancedMeshComponent.h"
+
+UBoidsInstancedMeshComponent::UBoidsInstancedMeshComponent()
+{
+	// Instances are written in world space every frame
+	SetUsingAbsoluteLocation(true);
+	SetUsingAbsoluteRotation(true);
+	SetUsingAbsoluteScale(true);
+
+	SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	SetGenerateOverlapEvents(false);
+	SetCanEverAffectNavigation(false);
+	Mobility = EComponentMobility::Movable;
+}
+
+void UBoidsInstancedMeshComponent::SetAnimationData(int32 InstanceIndex, float Phase, float Speed)
+{
+	const float AnimationData[NumAnimationFloats] = { Phase, Speed };
+	SetCustomData(InstanceIndex, MakeArrayView(AnimationData), false);
+}
+
+void UBoidsInstancedMeshComponent::SetFlockBounds(const FBox& Bounds)
+{
+	m_FlockBounds = Bounds;
+	UpdateBounds();
+}
+
+FBoxSphereBounds UBoidsInstancedMeshComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+	if (m_FlockBounds.IsValid)
+	{
+		return FBoxSphereBounds(m_FlockBounds.TransformBy(LocalToWorld));
+	}
+
+	return Super::CalcBounds(LocalToWorld);
+}
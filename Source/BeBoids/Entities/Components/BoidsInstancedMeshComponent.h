@@ -0,0 +1,38 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "BoidsInstancedMeshComponent.generated.h"
+
+/**
+ * UBoidsInstancedMeshComponent renders a whole flock as instances of one mesh.
+ * Instances are expected in world space, and the bounds are provided by the
+ * owner from the flock extent instead of being recomputed from every instance.
+ * Animated flocks pass the cycle phase and speed of each boid as per instance
+ * custom data, read by a vertex animation material.
+ */
+UCLASS(ClassGroup = Rendering)
+class BEBOIDS_API UBoidsInstancedMeshComponent : public UHierarchicalInstancedStaticMeshComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Custom data floats of an animated instance, the cycle phase then the speed ratio
+	static constexpr int32 NumAnimationFloats = 2;
+
+	// Constructor
+	UBoidsInstancedMeshComponent();
+
+	// Writes the animation custom data of one instance, sent to the renderer with the next batched transform update
+	void SetAnimationData(int32 InstanceIndex, float Phase, float Speed);
+
+	// Sets the world bounds of the flock, used until the next call
+	void SetFlockBounds(const FBox& Bounds);
+
+	// Returns the flock bounds when set, the instance bounds otherwise
+	virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+
+private:
+	// World bounds of the flock
+	FBox m_FlockBounds = FBox(ForceInit);
+};
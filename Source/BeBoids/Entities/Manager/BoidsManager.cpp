@@ -1,63 +1,1641 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-
-#include "BoidsManager.h"
-
-
-// Sets default values
-ABoidsManager::ABoidsManager()
-{
-	PrimaryActorTick.bCanEverTick = true;
-}
-
-void ABoidsManager::BeginPlay()
-{
-	Super::BeginPlay();
-
-	if (!BoidClass)
-	{
-		UE_LOG(LogTemp, Error, TEXT("BoidClass is not set in BoidsManager."));
-		return;
-	}
-
-	if (m_SpawnVolume.IsNearlyZero())
-	{
-		m_SpawnVolume = FVector(500.0f, 500.0f, 200.0f);
-		UE_LOG(LogTemp, Warning, TEXT("Spawn volume initialyse at value : (500,500,200)."));
-	}
-
-	for (int i = 0; i < m_NumBoids; i++)
-	{
-		FVector Position = GetActorLocation() + FVector(
-			FMath::RandRange(-m_SpawnVolume.X, m_SpawnVolume.X),
-			FMath::RandRange(-m_SpawnVolume.Y, m_SpawnVolume.Y),
-			FMath::RandRange(-m_SpawnVolume.Z, m_SpawnVolume.Z)
-		);
-
-		FActorSpawnParameters SpawnParams;
-		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
-
-		ABoids* NewBoid = GetWorld()->SpawnActor<ABoids>(BoidClass, Position, FRotator::ZeroRotator, SpawnParams);
-        
-		if (NewBoid)
-		{
-			SpawnedBoids.Add(NewBoid);
-            
-			// Initialisation supplémentaire si besoin
-			// NewBoid->SetInitialVelocity(...);
-		}
-		else
-		{
-			UE_LOG(LogTemp, Error, TEXT("Spawn Boids error at location: %s"), *Position.ToString());
-		}
-	}
-
-	UE_LOG(LogTemp, Log, TEXT("Spawned %d Boids on %d Given"), SpawnedBoids.Num(), m_NumBoids);
-}
-
-// Called every frame
-void ABoidsManager::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
-}
-
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BoidsManager.h"
+#include "BoidsStats.h"
+#include "Async/Async.h"
+#include "BeBoids/Entities/Mass/BoidsMassFragments.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "MassEntityManager.h"
+#include "MassEntitySubsystem.h"
+#include "MassExecutor.h"
+#include "Misc/Paths.h"
+#include "Net/UnrealNetwork.h"
+
+TRACE_DECLARE_INT_COUNTER(BoidsTracesIssuedCounter, TEXT("Boids/Traces Issued"));
+
+void FBoidsSpawnState::Generate(FRandomStream& InRandom, int32 NumBoids, const FVector& Center, const FVector& Extent, float Speed)
+{
+	Positions.SetNumUninitialized(NumBoids);
+	Velocities.SetNumUninitialized(NumBoids);
+
+	for (int32 i = 0; i < NumBoids; i++)
+	{
+		Positions[i] = Center + FVector(
+			InRandom.FRandRange(-Extent.X, Extent.X),
+			InRandom.FRandRange(-Extent.Y, Extent.Y),
+			InRandom.FRandRange(-Extent.Z, Extent.Z)
+		);
+	}
+
+	for (int32 i = 0; i < NumBoids; i++)
+	{
+		Velocities[i] = InRandom.GetUnitVector() * Speed;
+	}
+
+	Random = InRandom;
+}
+
+bool FBoidsFlockKeyframe::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	Ar << Seed;
+	Ar.SerializeIntPacked(StepIndex);
+	Ar.SerializeIntPacked(NumBoids);
+	Ar.SerializeIntPacked(FirstBoid);
+
+	uint32 NumBytes = Boids.Num();
+	Ar.SerializeIntPacked(NumBytes);
+
+	if (Ar.IsLoading())
+	{
+		if (NumBytes > uint32(MaxSliceBoids * FBoidsKeyframe::BoidSize) || NumBytes % FBoidsKeyframe::BoidSize != 0)
+		{
+			Ar.SetError();
+			bOutSuccess = false;
+			return true;
+		}
+		Boids.SetNumUninitialized(NumBytes);
+	}
+
+	Ar.Serialize(Boids.GetData(), NumBytes);
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+
+
+// Sets default values
+ABoidsManager::ABoidsManager()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	// Only the flock keyframe replicates, the manager becomes a replicated actor in PostInitProperties when m_bReplicateFlock is set
+	NetUpdateFrequency = 10.0f;
+
+	InstancedMesh = CreateDefaultSubobject<UBoidsInstancedMeshComponent>(TEXT("InstancedMesh"));
+	InstancedMesh->SetupAttachment(RootComponent);
+}
+
+void ABoidsManager::PostInitProperties()
+{
+	// Set before the actor picks its remote role, a flock spans the whole level so it is relevant to every connection
+	bReplicates = m_bReplicateFlock;
+	bAlwaysRelevant = m_bReplicateFlock;
+
+	Super::PostInitProperties();
+}
+
+void ABoidsManager::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// A level instance may override m_bReplicateFlock after its properties were initialized
+	if (HasAuthority() && GetIsReplicated() != m_bReplicateFlock)
+	{
+		bAlwaysRelevant = m_bReplicateFlock;
+		SetReplicates(m_bReplicateFlock);
+	}
+
+	if (!BoidClass)
+	{
+		UE_LOG(LogTemp, Error, TEXT("BoidClass is not set in BoidsManager."));
+		return;
+	}
+
+	if (m_SpawnVolume.IsNearlyZero())
+	{
+		m_SpawnVolume = FVector(500.0f, 500.0f, 200.0f);
+		UE_LOG(LogTemp, Warning, TEXT("Spawn volume initialyse at value : (500,500,200)."));
+	}
+
+	if (IsFlockReplicationClient() && m_ReplayMode != EBoidsReplayMode::None)
+	{
+		m_ReplayMode = EBoidsReplayMode::None;
+		UE_LOG(LogTemp, Warning, TEXT("Replicated clients follow the server flock, replays are disabled."));
+	}
+
+	if (m_bReplicateFlock && !m_bBatchSimulation)
+	{
+		m_bBatchSimulation = true;
+		UE_LOG(LogTemp, Warning, TEXT("Flock replication needs the batch simulation, enabling it."));
+	}
+
+	// Clients only predict the server flock when both ends count the same steps of the same length
+	if (m_bReplicateFlock && !m_bFixedTimestep)
+	{
+		m_bFixedTimestep = true;
+		UE_LOG(LogTemp, Warning, TEXT("Flock replication needs the fixed timestep, enabling it."));
+	}
+
+	if (m_Backend == EBoidsBackend::MassEntity && m_ReplayMode == EBoidsReplayMode::Playback)
+	{
+		m_Backend = EBoidsBackend::FlockSimulation;
+		UE_LOG(LogTemp, Warning, TEXT("Replay playback does not simulate the flock, the Mass backend is not used."));
+	}
+
+	if (m_Backend == EBoidsBackend::MassEntity)
+	{
+		// Mass boids have no actor, and every one of them is stepped at full rate
+		if (!m_bInstancedRendering)
+		{
+			m_bInstancedRendering = true;
+			UE_LOG(LogTemp, Warning, TEXT("The Mass backend renders through the instanced mesh, enabling it."));
+		}
+
+		if (m_bSimulationLod || m_SimulationBudgetMs > 0.0f)
+		{
+			m_bSimulationLod = false;
+			m_SimulationBudgetMs = 0.0f;
+			UE_LOG(LogTemp, Warning, TEXT("The Mass backend steps every boid each frame, simulation LOD and budget are ignored."));
+		}
+	}
+
+	if (m_bInstancedRendering && !m_bBatchSimulation)
+	{
+		m_bBatchSimulation = true;
+		UE_LOG(LogTemp, Warning, TEXT("Instanced rendering needs the batch simulation, enabling it."));
+	}
+
+	if (m_bFixedTimestep && !m_bBatchSimulation)
+	{
+		m_bBatchSimulation = true;
+		UE_LOG(LogTemp, Warning, TEXT("Fixed timestep needs the batch simulation, enabling it."));
+	}
+
+	if (m_ReplayMode == EBoidsReplayMode::Playback)
+	{
+		if (m_ReplayReader.Open(GetReplayPath()))
+		{
+			// The replay decides the flock size, and steps are already blended by the playback
+			m_NumBoids = m_ReplayReader.GetNumBoids();
+			m_bBatchSimulation = true;
+			m_bFixedTimestep = false;
+		}
+		else
+		{
+			m_ReplayMode = EBoidsReplayMode::None;
+		}
+	}
+
+	if (m_ReplayMode == EBoidsReplayMode::Record && !m_bBatchSimulation)
+	{
+		m_bBatchSimulation = true;
+		UE_LOG(LogTemp, Warning, TEXT("Replay recording needs the batch simulation, enabling it."));
+	}
+
+	// A settled flock saved earlier replaces the random spawn, its size and seed win over the manager ones
+	if (!m_SnapshotFile.IsEmpty() && m_ReplayMode != EBoidsReplayMode::Playback && m_Snapshot.Open(GetSnapshotPath()))
+	{
+		m_NumBoids = m_Snapshot.GetNumBoids();
+		m_Seed = int32(m_Snapshot.GetSeed());
+		UE_LOG(LogTemp, Log, TEXT("Warm starting %d boids from %s."), m_NumBoids, *GetSnapshotPath());
+	}
+
+	if (m_Seed == 0)
+	{
+		m_Seed = FMath::Max(FMath::Rand(), 1);
+	}
+	UE_LOG(LogTemp, Log, TEXT("BoidsManager seed: %d"), m_Seed);
+
+	// Boids without any blocking response can not be pushed out of the world, the spawn adjustment is skipped
+	m_bAdjustSpawnLocation = !m_bCollisionFreeBoids && BoidClass->GetDefaultObject<ABoids>()->HasBlockingCollision();
+
+	// Spawn positions and start velocities come from the seed, so a seed always gives the same flock
+	m_SpawnRandom.Initialize(m_Seed);
+
+	// The whole pool is spawned once, boids beyond m_NumBoids wait hidden until SpawnBoids activates them
+	const int32 PoolSize = FMath::Max(m_NumBoids, m_PoolSize);
+	const FVector Center = GetActorLocation();
+	const FVector SpawnVolume = m_SpawnVolume;
+	const float MinSpeed = m_Snapshot.IsOpen() ? m_Snapshot.GetSettings().MinSpeed : BoidClass->GetDefaultObject<ABoids>()->GetSettings().MinSpeed;
+
+	// Time-sliced spawning draws the spawn state on a worker, the flock starts on the first tick after it is ready
+	if (m_SpawnBudgetMs > 0.0f)
+	{
+		m_SpawnTask = Async(EAsyncExecution::ThreadPool, [Random = m_SpawnRandom, PoolSize, Center, SpawnVolume, MinSpeed]() mutable
+		{
+			FBoidsSpawnState SpawnState;
+			SpawnState.Generate(Random, PoolSize, Center, SpawnVolume, MinSpeed);
+			return SpawnState;
+		});
+		return;
+	}
+
+	FBoidsSpawnState SpawnState;
+	SpawnState.Generate(m_SpawnRandom, PoolSize, Center, SpawnVolume, MinSpeed);
+	InitializeFlock(MoveTemp(SpawnState));
+}
+
+void ABoidsManager::InitializeFlock(FBoidsSpawnState&& SpawnState)
+{
+	// The spawn stream goes on from where the generation stopped, runtime spawns draw the same values either way
+	m_SpawnRandom = SpawnState.Random;
+
+	if (m_Snapshot.IsOpen())
+	{
+		for (int32 i = 0; i < m_Snapshot.GetNumBoids() && i < SpawnState.Positions.Num(); i++)
+		{
+			SpawnState.Positions[i] = m_Snapshot.GetPositions()[i];
+		}
+	}
+
+	// Time-sliced actors are spawned by the following ticks, the flock grows as they appear
+	const bool bSpawnActors = !m_bInstancedRendering && m_SpawnBudgetMs <= 0.0f;
+
+	TArray<FVector> StartPositions;
+	TArray<FVector> StartVelocities;
+	if (bSpawnActors)
+	{
+		StartPositions.Reserve(SpawnState.Positions.Num());
+		StartVelocities.Reserve(SpawnState.Positions.Num());
+
+		for (int32 i = 0; i < SpawnState.Positions.Num(); i++)
+		{
+			if (ABoids* NewBoid = SpawnBoidActor(SpawnState.Positions[i]))
+			{
+				StartPositions.Add(NewBoid->GetActorLocation());
+				StartVelocities.Add(SpawnState.Velocities[i]);
+			}
+		}
+
+		UE_LOG(LogTemp, Log, TEXT("Spawned %d Boids on %d Given"), StartPositions.Num(), SpawnState.Positions.Num());
+	}
+	else
+	{
+		// Instanced boids only exist in the flock state, no actor is spawned
+		StartPositions = MoveTemp(SpawnState.Positions);
+		StartVelocities = MoveTemp(SpawnState.Velocities);
+	}
+
+	// Cells of the spatial grid match the perception radius so a query only visits the 27 surrounding cells
+	FBoidsSettings Settings = m_Snapshot.IsOpen() ? m_Snapshot.GetSettings() : BoidClass->GetDefaultObject<ABoids>()->GetSettings();
+	Settings.bSingleIntegration = m_bFixedTimestep;
+	m_Simulation.Initialize(Settings, StartPositions.Num());
+	m_Simulation.SetNumActive(m_NumBoids);
+	m_Simulation.SetParallel(m_bParallelSimulation);
+	m_Simulation.SetSeed(m_Seed);
+	m_Simulation.SetStepBudget(m_SimulationBudgetMs / 1000.0);
+
+	FBoidsLodSettings LodSettings;
+	LodSettings.MidInterval = m_LodMidInterval;
+	LodSettings.FarInterval = m_LodFarInterval;
+	LodSettings.FarMaxNeighbors = m_LodFarMaxNeighbors;
+	m_Simulation.SetLodSettings(LodSettings);
+
+	if (m_DistanceField && m_DistanceField->GetField().IsValid())
+	{
+		m_Simulation.SetDistanceField(&m_DistanceField->GetField());
+	}
+
+	FBoidsFlockState& State = m_Simulation.GetState();
+	State.Positions = MoveTemp(StartPositions);
+	State.Velocities = MoveTemp(StartVelocities);
+
+	if (m_ReplayMode == EBoidsReplayMode::Playback)
+	{
+		m_Simulation.SetNumActive(m_ReplayReader.Sample(0.0f, State));
+	}
+	m_Simulation.CopyStateToPrevious();
+
+	// Every boid spawned, the whole state comes back in one copy per array
+	if (m_Snapshot.IsOpen() && State.Num() >= m_Snapshot.GetNumBoids())
+	{
+		m_Snapshot.Restore(m_Simulation);
+	}
+	m_Snapshot.Close();
+
+	// No actor exists yet, they join the flock as the time slices spawn them
+	if (!bSpawnActors && !m_bInstancedRendering && m_ReplayMode != EBoidsReplayMode::Playback)
+	{
+		m_Simulation.SetNumActive(0);
+	}
+
+	for (int32 i = 0; i < SpawnedBoids.Num() && i < State.Num(); i++)
+	{
+		SpawnedBoids[i]->SetInitialState(State.Velocities[i], m_Seed);
+	}
+
+	if (m_ReplayMode == EBoidsReplayMode::Record)
+	{
+		m_ReplayWriter.Open(GetReplayPath(), State.Num());
+		m_ReplayWriter.WriteFrame(0.0f, State, m_Simulation.GetNumActive());
+	}
+
+	// In batch mode the manager steps the flock, boid actors only carry the visuals
+	for (int32 i = 0; i < SpawnedBoids.Num(); i++)
+	{
+		UpdateBoidActivation(i);
+	}
+
+	if (m_bInstancedRendering)
+	{
+		InitializeInstances();
+	}
+
+	m_Simulation.RebuildGrid();
+
+	if (m_Backend == EBoidsBackend::MassEntity)
+	{
+		InitializeMassFlock();
+	}
+}
+
+void ABoidsManager::InitializeMassFlock()
+{
+	if (!GetWorld()->GetSubsystem<UMassEntitySubsystem>())
+	{
+		m_Backend = EBoidsBackend::FlockSimulation;
+		UE_LOG(LogTemp, Error, TEXT("No Mass entity subsystem in this world, the BoidsManager falls back to the flock simulation."));
+		return;
+	}
+	FMassEntityManager& EntityManager = GetMassEntityManager();
+
+	// The steering parameters are shared by the whole flock, the manager id keeps each flock in its own chunks
+	FBoidsMassParamsFragment Params;
+	Params.FlockId = GetUniqueID();
+	Params.Settings = m_Simulation.GetSettings();
+
+	FMassArchetypeSharedFragmentValues SharedValues;
+	SharedValues.AddConstSharedFragment(EntityManager.GetOrCreateConstSharedFragment(Params));
+	SharedValues.Sort();
+
+	FMassArchetypeCompositionDescriptor Composition;
+	Composition.Fragments.Add<FBoidsMassPositionFragment>();
+	Composition.Fragments.Add<FBoidsMassVelocityFragment>();
+	Composition.Fragments.Add<FBoidsMassIndexFragment>();
+	Composition.Fragments.Add<FBoidsMassSteeringFragment>();
+	Composition.Fragments.Add<FBoidsMassAvoidanceFragment>();
+	Composition.ConstSharedFragments.Add<FBoidsMassParamsFragment>();
+
+	// Pooled boids get an entity too, the processors skip them until they are activated
+	const FMassArchetypeHandle Archetype = EntityManager.CreateArchetype(Composition);
+	EntityManager.BatchCreateEntities(Archetype, SharedValues, m_Simulation.GetState().Num(), m_MassEntities);
+	for (int32 i = 0; i < m_MassEntities.Num(); i++)
+	{
+		WriteMassBoid(i);
+	}
+
+	m_MassFlock.FlockId = Params.FlockId;
+	m_MassFlock.Seed = m_Seed;
+	m_MassFlock.DistanceField = m_DistanceField && m_DistanceField->GetField().IsValid() ? &m_DistanceField->GetField() : nullptr;
+
+	// Sums are gathered from the fragments before any boid moves, then every boid is integrated
+	UBoidsMassProcessor* FlockProcessors[] = { NewObject<UBoidsMassNeighborProcessor>(this), NewObject<UBoidsMassAvoidanceProcessor>(this), NewObject<UBoidsMassSteeringProcessor>(this) };
+
+	TArray<UMassProcessor*> Processors;
+	for (UBoidsMassProcessor* Processor : FlockProcessors)
+	{
+		Processor->SetFlock(&m_MassFlock);
+		Processors.Add(Processor);
+	}
+	m_MassPipeline.SetProcessors(MoveTemp(Processors));
+	m_MassPipeline.Initialize(*this);
+
+	UE_LOG(LogTemp, Log, TEXT("Created %d Mass boids"), m_MassEntities.Num());
+}
+
+void ABoidsManager::StepMassFlock(float DeltaTime, TConstArrayView<FBoidsAvoidance> Avoidance)
+{
+	// The entities hold the flock, the state before the step is kept for interpolation and the processors write the new one
+	m_Simulation.CopyStateToPrevious();
+
+	m_MassFlock.NumActive = m_Simulation.GetNumActive();
+	m_MassFlock.StepIndex = m_Simulation.GetStepIndex();
+	m_MassFlock.State = &m_Simulation.GetState();
+	m_MassFlock.Avoidance = Avoidance;
+	m_MassFlock.Lods = AsConst(m_Simulation).GetLods();
+
+	FMassProcessingContext ProcessingContext(GetMassEntityManager(), DeltaTime);
+	UE::Mass::Executor::Run(m_MassPipeline, ProcessingContext);
+	m_MassFlock.Avoidance = TConstArrayView<FBoidsAvoidance>();
+
+	m_Simulation.SetStepIndex(m_MassFlock.StepIndex + 1);
+}
+
+void ABoidsManager::WriteMassBoid(int32 Index)
+{
+	FMassEntityManager& EntityManager = GetMassEntityManager();
+	const FBoidsFlockState& State = m_Simulation.GetState();
+	const FMassEntityHandle Entity = m_MassEntities[Index];
+
+	EntityManager.GetFragmentDataChecked<FBoidsMassPositionFragment>(Entity).Value = State.Positions[Index];
+	EntityManager.GetFragmentDataChecked<FBoidsMassVelocityFragment>(Entity).Value = State.Velocities[Index];
+	EntityManager.GetFragmentDataChecked<FBoidsMassIndexFragment>(Entity).Index = Index;
+}
+
+FMassEntityManager& ABoidsManager::GetMassEntityManager() const
+{
+	return GetWorld()->GetSubsystem<UMassEntitySubsystem>()->GetMutableEntityManager();
+}
+
+ABoids* ABoidsManager::SpawnBoidActor(const FVector& Position)
+{
+	ABoids* NewBoid = nullptr;
+
+	if (m_bCollisionFreeBoids || !m_bAdjustSpawnLocation)
+	{
+		// Deferred so a collision-free boid drops its collision before components initialize, without blocking collision there is nothing to adjust against
+		const FTransform SpawnTransform(Position);
+		NewBoid = GetWorld()->SpawnActorDeferred<ABoids>(BoidClass, SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		if (NewBoid)
+		{
+			NewBoid->m_bCollisionFree = m_bCollisionFreeBoids;
+			NewBoid->FinishSpawning(SpawnTransform);
+		}
+	}
+	else
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+		NewBoid = GetWorld()->SpawnActor<ABoids>(BoidClass, Position, FRotator::ZeroRotator, SpawnParams);
+	}
+
+	if (NewBoid)
+	{
+		NewBoid->SetManager(this, SpawnedBoids.Num());
+		SpawnedBoids.Add(NewBoid);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("Spawn Boids error at location: %s"), *Position.ToString());
+	}
+
+	return NewBoid;
+}
+
+void ABoidsManager::SpawnPendingActors()
+{
+	FBoidsFlockState& State = m_Simulation.GetState();
+	const double Deadline = FPlatformTime::Seconds() + m_SpawnBudgetMs / 1000.0;
+
+	// At least one actor per frame, so a tiny budget still finishes
+	do
+	{
+		const int32 Index = SpawnedBoids.Num();
+		ABoids* NewBoid = SpawnBoidActor(State.Positions[Index]);
+		if (!NewBoid)
+		{
+			// A missing actor keeps its slot, so actors and flock state indices stay aligned
+			SpawnedBoids.Add(nullptr);
+			continue;
+		}
+
+		if (m_ReplayMode != EBoidsReplayMode::Playback)
+		{
+			m_Simulation.ResetBoid(Index, NewBoid->GetActorLocation(), State.Velocities[Index]);
+		}
+		NewBoid->SetInitialState(State.Velocities[Index], m_Seed);
+		UpdateBoidActivation(Index);
+	}
+	while (SpawnedBoids.Num() < State.Num() && FPlatformTime::Seconds() < Deadline);
+
+	// The flock grows as its actors appear, up to the requested population
+	if (m_ReplayMode != EBoidsReplayMode::Playback && m_Simulation.GetNumActive() < FMath::Min(m_NumBoids, SpawnedBoids.Num()))
+	{
+		SetNumActiveBoids(FMath::Min(m_NumBoids, SpawnedBoids.Num()));
+	}
+
+	if (SpawnedBoids.Num() == State.Num())
+	{
+		UE_LOG(LogTemp, Log, TEXT("Spawned %d Boids over time slices of %.2f ms"), State.Num(), m_SpawnBudgetMs);
+	}
+}
+
+void ABoidsManager::UpdateBoidActivation(int32 Index)
+{
+	if (ABoids* Boid = SpawnedBoids[Index])
+	{
+		// Pooled actors stay in the world, only hidden and asleep, so do the actors of a sleeping cluster
+		const bool bActive = Index < m_Simulation.GetNumActive();
+		const TConstArrayView<EBoidsLod> Lods = AsConst(m_Simulation).GetLods();
+		const bool bAsleep = Lods.IsValidIndex(Index) && Lods[Index] == EBoidsLod::Asleep;
+		Boid->SetActorTickEnabled(bActive && !m_bBatchSimulation && !bAsleep);
+		Boid->SetActorHiddenInGame(!bActive);
+		Boid->SetActorEnableCollision(bActive);
+	}
+}
+
+void ABoidsManager::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ABoidsManager, m_Keyframe);
+}
+
+bool ABoidsManager::IsFlockReplicationClient() const
+{
+	return m_bReplicateFlock && GetNetMode() == NM_Client;
+}
+
+bool ABoidsManager::IsFlockReplicationServer() const
+{
+	return m_bReplicateFlock && (GetNetMode() == NM_DedicatedServer || GetNetMode() == NM_ListenServer);
+}
+
+void ABoidsManager::UpdateKeyframe(float DeltaTime)
+{
+	if (!IsFlockReplicationServer())
+	{
+		return;
+	}
+
+	m_KeyframeTimer += DeltaTime;
+	if (m_KeyframeTimer >= m_KeyframeInterval)
+	{
+		m_KeyframeTimer = FMath::Fmod(m_KeyframeTimer, m_KeyframeInterval);
+		WriteKeyframe();
+	}
+}
+
+void ABoidsManager::WriteKeyframe()
+{
+	// Each keyframe carries the slice after the previous one, wrapping to the first boid once the flock is covered
+	const int32 NumActive = m_Simulation.GetNumActive();
+	if (m_KeyframeCursor >= NumActive)
+	{
+		m_KeyframeCursor = 0;
+	}
+	const int32 SliceSize = FMath::Min(FMath::Clamp(m_KeyframeSliceSize, 1, FBoidsFlockKeyframe::MaxSliceBoids), NumActive - m_KeyframeCursor);
+
+	m_Keyframe.Seed = uint32(m_Seed);
+	m_Keyframe.StepIndex = m_Simulation.GetStepIndex();
+	m_Keyframe.NumBoids = NumActive;
+	m_Keyframe.FirstBoid = m_KeyframeCursor;
+	FBoidsKeyframe::Encode(m_Simulation.GetState(), m_KeyframeCursor, SliceSize, GetActorLocation(), m_ReplicationExtent, m_Keyframe.Boids);
+	m_KeyframeCursor += SliceSize;
+
+	UE_LOG(LogTemp, Verbose, TEXT("Flock keyframe at step %u: boids %u to %d of %d, %d bytes"), m_Keyframe.StepIndex, m_Keyframe.FirstBoid, m_KeyframeCursor, NumActive, m_Keyframe.Boids.Num());
+	ForceNetUpdate();
+}
+
+void ABoidsManager::OnRep_Keyframe()
+{
+	if (!IsFlockReplicationClient())
+	{
+		return;
+	}
+
+	// The flock may still be spawning, the keyframe is applied once it exists
+	if (m_SpawnTask.IsValid() || m_Simulation.GetState().Num() == 0)
+	{
+		m_bKeyframePending = true;
+		return;
+	}
+
+	ApplyKeyframe();
+}
+
+void ABoidsManager::ApplyKeyframe()
+{
+	m_bKeyframePending = false;
+
+	// The server seed keys the random streams, so both ends step alike between keyframes
+	if (m_Keyframe.Seed != 0 && m_Keyframe.Seed != uint32(m_Seed))
+	{
+		m_Seed = int32(m_Keyframe.Seed);
+		m_Simulation.SetSeed(m_Seed);
+		m_MassFlock.Seed = m_Seed;
+	}
+
+	const int32 PreviousNumActive = m_Simulation.GetNumActive();
+	const int32 NumBoids = int32(FMath::Min<uint32>(m_Keyframe.NumBoids, uint32(GetPoolCapacity())));
+	if (uint32(NumBoids) < m_Keyframe.NumBoids)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("The client pool holds %d of the %u replicated boids, match the pool size of the server."), NumBoids, m_Keyframe.NumBoids);
+	}
+
+	// Only the boids of the slice are corrected, the others keep simulating from the previous slices
+	const int32 FirstBoid = int32(FMath::Min<uint32>(m_Keyframe.FirstBoid, uint32(NumBoids)));
+	const int32 EndBoid = FMath::Min(FirstBoid + FBoidsKeyframe::GetNumBoids(m_Keyframe.Boids), NumBoids);
+
+	// Positions rendered before the correction, the jump is blended out from them
+	TArray<FVector> RenderedPositions;
+	RenderedPositions.SetNumUninitialized(EndBoid - FirstBoid);
+	for (int32 i = FirstBoid; i < EndBoid && i < PreviousNumActive; i++)
+	{
+		FVector Velocity;
+		GetRenderState(i, RenderedPositions[i - FirstBoid], Velocity);
+	}
+
+	// Corrections of the previous slices are carried over at their current weight, so they keep fading from where they are
+	m_Corrections.SetNumZeroed(NumBoids, EAllowShrinking::No);
+	for (FVector& Correction : m_Corrections)
+	{
+		Correction *= m_CorrectionAlpha;
+	}
+	m_CorrectionAlpha = 0.0f;
+
+	// Headings come from the server, speeds are kept from the local flock
+	const FBoidsSettings& Settings = m_Simulation.GetSettings();
+	for (int32 i = FirstBoid; i < EndBoid; i++)
+	{
+		FVector Position;
+		FVector Heading;
+		FBoidsKeyframe::DecodeBoid(m_Keyframe.Boids, i - FirstBoid, GetActorLocation(), m_ReplicationExtent, Position, Heading);
+
+		const float Speed = i < PreviousNumActive ? FMath::Clamp(float(m_Simulation.GetState().Velocities[i].Size()), Settings.MinSpeed, Settings.MaxSpeed) : Settings.MinSpeed;
+		m_Simulation.ResetBoid(i, Position, Heading * Speed);
+
+		if (m_MassEntities.IsValidIndex(i))
+		{
+			WriteMassBoid(i);
+		}
+	}
+	SetNumActiveBoids(NumBoids);
+
+	// Avoidance gathered before the correction describes the uncorrected flock, it is dropped with the rays in flight
+	m_Avoidance.Reset();
+	m_PendingTraces.Reset();
+
+	// The fixed timestep makes both ends count the same steps, a client behind the server jumps to its step
+	// The step index never moves back, the local flock and the other slices already live at the local step
+	const uint32 LocalStepIndex = m_Simulation.GetStepIndex();
+	if (LocalStepIndex < m_Keyframe.StepIndex)
+	{
+		m_Simulation.SetStepIndex(m_Keyframe.StepIndex);
+	}
+
+	// A late slice is stepped up to the local step while the other boids, already there, are held still
+	// Past m_MaxCatchUpSteps only the last steps are run, the slice skips the older ones
+	if (m_bFixedTimestep && LocalStepIndex > m_Keyframe.StepIndex && EndBoid > FirstBoid)
+	{
+		const uint32 StepsBehind = LocalStepIndex - m_Keyframe.StepIndex;
+		const int32 NumCatchUpSteps = int32(FMath::Min<uint32>(StepsBehind, uint32(m_MaxCatchUpSteps)));
+		if (StepsBehind > uint32(m_MaxCatchUpSteps))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Keyframe at step %u is %u steps behind the client, only the last %d are caught up."), m_Keyframe.StepIndex, StepsBehind, NumCatchUpSteps);
+		}
+
+		TArrayView<EBoidsLod> Lods = m_Simulation.GetLods();
+		const TArray<EBoidsLod> LocalLods(Lods);
+		for (int32 i = 0; i < NumBoids && i < Lods.Num(); i++)
+		{
+			Lods[i] = i >= FirstBoid && i < EndBoid ? EBoidsLod::Near : EBoidsLod::Asleep;
+		}
+
+		StepWithoutAvoidance(NumCatchUpSteps, 1.0f / m_SimulationRate, LocalStepIndex - NumCatchUpSteps);
+
+		for (int32 i = 0; i < Lods.Num(); i++)
+		{
+			Lods[i] = LocalLods[i];
+		}
+	}
+
+	// Boids that just joined have nothing to blend from
+	for (int32 i = FirstBoid; i < EndBoid; i++)
+	{
+		FVector Position;
+		FVector Velocity;
+		GetRenderState(i, Position, Velocity);
+		m_Corrections[i] = i < PreviousNumActive ? RenderedPositions[i - FirstBoid] - Position : FVector::ZeroVector;
+	}
+	m_CorrectionAlpha = m_CorrectionTime > 0.0f ? 1.0f : 0.0f;
+}
+
+void ABoidsManager::StepWithoutAvoidance(int32 NumSteps, float StepTime, uint32 FirstStepIndex)
+{
+	const uint32 StepIndex = m_Simulation.GetStepIndex();
+	m_Simulation.SetStepIndex(FirstStepIndex);
+	for (int32 Step = 0; Step < NumSteps; Step++)
+	{
+		if (m_Backend == EBoidsBackend::MassEntity)
+		{
+			StepMassFlock(StepTime, TConstArrayView<FBoidsAvoidance>());
+		}
+		else
+		{
+			m_Simulation.Step(StepTime, TConstArrayView<FBoidsAvoidance>());
+		}
+	}
+	m_Simulation.SetStepIndex(StepIndex);
+}
+
+void ABoidsManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	m_ReplayWriter.Close();
+
+	if (m_MassEntities.Num() > 0)
+	{
+		if (GetWorld()->GetSubsystem<UMassEntitySubsystem>())
+		{
+			GetMassEntityManager().BatchDestroyEntities(m_MassEntities);
+		}
+		m_MassEntities.Reset();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+// Called every frame
+void ABoidsManager::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Sources following a destroyed actor go away on every frame, whether or not the flock is stepped
+	m_InfluenceSources.RemoveAll([](const FBoidsInfluenceSource& Source) { return Source.bFollowsActor && !Source.Actor.IsValid(); });
+
+	// The flock starts once the spawn state drawn on a worker is ready
+	if (m_SpawnTask.IsValid())
+	{
+		if (!m_SpawnTask.IsReady())
+		{
+			return;
+		}
+		InitializeFlock(m_SpawnTask.Consume());
+	}
+
+	if (m_bKeyframePending)
+	{
+		ApplyKeyframe();
+	}
+
+	if (m_CorrectionAlpha > 0.0f)
+	{
+		m_CorrectionAlpha = FMath::Max(m_CorrectionAlpha - DeltaTime / m_CorrectionTime, 0.0f);
+	}
+
+	if (!m_bInstancedRendering && SpawnedBoids.Num() < m_Simulation.GetState().Num())
+	{
+		SpawnPendingActors();
+	}
+
+	if (m_ReplayMode == EBoidsReplayMode::Playback)
+	{
+		// The replay loops once its last frame is reached
+		m_ReplayTime += DeltaTime;
+		if (m_ReplayTime > m_ReplayReader.GetDuration())
+		{
+			m_ReplayTime = m_ReplayReader.GetDuration() > 0.0f ? FMath::Fmod(m_ReplayTime, m_ReplayReader.GetDuration()) : 0.0f;
+		}
+
+		m_LastFrameTimings = FBoidsFrameTimings();
+		SetNumActiveBoids(m_ReplayReader.Sample(m_ReplayTime, m_Simulation.GetState()));
+
+		const double WriteBackStartTime = FPlatformTime::Seconds();
+		if (m_bInstancedRendering)
+		{
+			WriteBackInstances(DeltaTime);
+		}
+		else
+		{
+			WriteBackTransforms();
+		}
+		m_LastFrameTimings.WriteBackMs = (FPlatformTime::Seconds() - WriteBackStartTime) * 1000.0;
+		return;
+	}
+
+	// A sleeping server keeps sending its frozen flock, clients joining or drifting still settle on it
+	if (m_bSleepWhenIrrelevant && UpdateSleep(DeltaTime))
+	{
+		m_LastFrameTimings = FBoidsFrameTimings();
+		UpdateKeyframe(DeltaTime);
+		return;
+	}
+
+	if (!m_bBatchSimulation)
+	{
+		const double GridStartTime = FPlatformTime::Seconds();
+		RebuildSpatialGrid();
+
+		m_LastFrameTimings = FBoidsFrameTimings();
+		m_LastFrameTimings.NeighborSearchMs = (FPlatformTime::Seconds() - GridStartTime) * 1000.0;
+		return;
+	}
+
+	UpdateInfluences();
+
+	if (m_bSimulationLod)
+	{
+		UpdateLods();
+	}
+
+	m_LastFrameTimings = FBoidsFrameTimings();
+	double AvoidanceSeconds = 0.0;
+	int32 NumSteps = 1;
+	float StepTime = DeltaTime;
+
+	// The fixed timestep runs as many steps as the accumulated frame time allows, rendering blends the remainder
+	if (m_bFixedTimestep)
+	{
+		StepTime = 1.0f / m_SimulationRate;
+		m_TimeAccumulator += DeltaTime;
+		NumSteps = FMath::Min(FMath::FloorToInt32(m_TimeAccumulator / StepTime), m_MaxSimulationSteps);
+		m_TimeAccumulator = FMath::Min(m_TimeAccumulator - NumSteps * StepTime, StepTime);
+		m_InterpolationAlpha = m_TimeAccumulator / StepTime;
+	}
+
+	// Rays of the previous frame are read on every frame, stepped or not, so their handles are never more than one frame old
+	const bool bAsyncTraces = m_bAsyncObstacleTraces && !m_Simulation.HasDistanceField();
+	if (bAsyncTraces)
+	{
+		const double ConsumeStartTime = FPlatformTime::Seconds();
+		ConsumeObstacleTraces();
+		AvoidanceSeconds += FPlatformTime::Seconds() - ConsumeStartTime;
+	}
+
+	for (int32 StepIndex = 0; StepIndex < NumSteps; StepIndex++)
+	{
+		StepSimulation(StepTime, AvoidanceSeconds);
+
+		m_ReplayTime += StepTime;
+		m_ReplayWriter.WriteFrame(m_ReplayTime, m_Simulation.GetState(), m_Simulation.GetNumActive());
+	}
+
+	UpdateKeyframe(DeltaTime);
+
+	// Rays issued after the last step are read on the next frame, their avoidance is kept for every step until then
+	if (bAsyncTraces)
+	{
+		const double IssueStartTime = FPlatformTime::Seconds();
+		IssueObstacleTraces();
+		AvoidanceSeconds += FPlatformTime::Seconds() - IssueStartTime;
+	}
+
+	const double WriteBackStartTime = FPlatformTime::Seconds();
+	if (m_bInstancedRendering)
+	{
+		WriteBackInstances(DeltaTime);
+	}
+	else
+	{
+		WriteBackTransforms();
+	}
+
+	m_LastFrameTimings.AvoidanceMs = AvoidanceSeconds * 1000.0;
+	m_LastFrameTimings.WriteBackMs = (FPlatformTime::Seconds() - WriteBackStartTime) * 1000.0;
+}
+
+void ABoidsManager::StepSimulation(float DeltaTime, double& AvoidanceSeconds)
+{
+	// With a baked distance field the simulation avoids obstacles without any scene query, asynchronous rays are read by the tick
+	if (!m_Simulation.HasDistanceField() && !m_bAsyncObstacleTraces)
+	{
+		const double AvoidanceStartTime = FPlatformTime::Seconds();
+		GatherObstacleAvoidance();
+		AvoidanceSeconds += FPlatformTime::Seconds() - AvoidanceStartTime;
+	}
+
+	// The Mass processors read the same avoidance input, the whole pipeline counts as steering
+	if (m_Backend == EBoidsBackend::MassEntity)
+	{
+		const double StepStartTime = FPlatformTime::Seconds();
+		StepMassFlock(DeltaTime, m_Avoidance);
+		m_LastFrameTimings.SteeringMs += (FPlatformTime::Seconds() - StepStartTime) * 1000.0;
+		return;
+	}
+
+	m_Simulation.Step(DeltaTime, m_Avoidance);
+
+	const FBoidsStepTimings& StepTimings = m_Simulation.GetLastStepTimings();
+	m_LastFrameTimings.NeighborSearchMs += StepTimings.NeighborSearchSeconds * 1000.0;
+	m_LastFrameTimings.SteeringMs += StepTimings.SteeringSeconds * 1000.0;
+}
+
+FString ABoidsManager::GetReplayPath() const
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), m_ReplayFile);
+}
+
+FString ABoidsManager::GetSnapshotPath() const
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), m_SnapshotFile);
+}
+
+void ABoidsManager::SaveSnapshot()
+{
+	if (m_SnapshotFile.IsEmpty())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Set the snapshot file of the BoidsManager before saving."));
+		return;
+	}
+
+	if (m_Simulation.GetNumActive() == 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("The BoidsManager has no flock to save, snapshots are taken while playing."));
+		return;
+	}
+
+	if (FBoidsSnapshot::Save(GetSnapshotPath(), m_Simulation))
+	{
+		UE_LOG(LogTemp, Log, TEXT("Saved %d boids to %s."), m_Simulation.GetNumActive(), *GetSnapshotPath());
+	}
+}
+
+int32 ABoidsManager::SpawnBoids(int32 Count, FVector Location, float Radius)
+{
+	if (m_ReplayMode == EBoidsReplayMode::Playback)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("The replay drives the flock size during playback, SpawnBoids is ignored."));
+		return 0;
+	}
+
+	if (IsFlockReplicationClient())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("The server drives the size of a replicated flock, SpawnBoids is ignored on clients."));
+		return 0;
+	}
+
+	const int32 NumActive = m_Simulation.GetNumActive();
+	const int32 NumSpawned = FMath::Clamp(Count, 0, GetPoolCapacity() - NumActive);
+	if (NumSpawned < Count)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Boids pool exhausted, %d of %d boids spawned, raise the pool size of the BoidsManager."), NumSpawned, Count);
+	}
+
+	for (int32 i = NumActive; i < NumActive + NumSpawned; i++)
+	{
+		ResetPooledBoid(i, Location + m_SpawnRandom.GetUnitVector() * m_SpawnRandom.FRandRange(0.0f, Radius));
+	}
+
+	SetNumActiveBoids(NumActive + NumSpawned);
+	return NumSpawned;
+}
+
+int32 ABoidsManager::DespawnBoids(int32 Count)
+{
+	if (m_ReplayMode == EBoidsReplayMode::Playback)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("The replay drives the flock size during playback, DespawnBoids is ignored."));
+		return 0;
+	}
+
+	if (IsFlockReplicationClient())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("The server drives the size of a replicated flock, DespawnBoids is ignored on clients."));
+		return 0;
+	}
+
+	// The active boids stay packed at the start of the state, so the last ones leave first
+	const int32 NumActive = m_Simulation.GetNumActive();
+	const int32 NumDespawned = FMath::Clamp(Count, 0, NumActive);
+
+	SetNumActiveBoids(NumActive - NumDespawned);
+	return NumDespawned;
+}
+
+void ABoidsManager::SetPopulation(int32 NumBoids)
+{
+	if (IsFlockReplicationClient())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("The server drives the size of a replicated flock, SetPopulation is ignored on clients."));
+		return;
+	}
+
+	const int32 NumActive = m_Simulation.GetNumActive();
+	if (NumBoids <= NumActive)
+	{
+		DespawnBoids(NumActive - NumBoids);
+		return;
+	}
+
+	if (m_ReplayMode == EBoidsReplayMode::Playback)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("The replay drives the flock size during playback, SetPopulation is ignored."));
+		return;
+	}
+
+	const int32 NumSpawned = FMath::Min(NumBoids, GetPoolCapacity()) - NumActive;
+	if (NumSpawned < NumBoids - NumActive)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Boids pool exhausted, the flock is capped at %d boids, raise the pool size of the BoidsManager."), GetPoolCapacity());
+	}
+
+	for (int32 i = NumActive; i < NumActive + NumSpawned; i++)
+	{
+		ResetPooledBoid(i, GetActorLocation() + FVector(
+			m_SpawnRandom.FRandRange(-m_SpawnVolume.X, m_SpawnVolume.X),
+			m_SpawnRandom.FRandRange(-m_SpawnVolume.Y, m_SpawnVolume.Y),
+			m_SpawnRandom.FRandRange(-m_SpawnVolume.Z, m_SpawnVolume.Z)
+		));
+	}
+
+	SetNumActiveBoids(NumActive + NumSpawned);
+}
+
+void ABoidsManager::ResetPooledBoid(int32 Index, const FVector& Position)
+{
+	const FVector Velocity = m_SpawnRandom.GetUnitVector() * m_Simulation.GetSettings().MinSpeed;
+	m_Simulation.ResetBoid(Index, Position, Velocity);
+
+	if (m_MassEntities.IsValidIndex(Index))
+	{
+		WriteMassBoid(Index);
+	}
+
+	// Actors of the actor simulation read their own transform, batch ones are moved on the next write back
+	if (SpawnedBoids.IsValidIndex(Index) && SpawnedBoids[Index])
+	{
+		SpawnedBoids[Index]->SetActorLocationAndRotation(Position, Velocity.Rotation(), false, nullptr, ETeleportType::TeleportPhysics);
+		SpawnedBoids[Index]->SetInitialState(Velocity, m_Seed);
+	}
+}
+
+void ABoidsManager::SetNumActiveBoids(int32 NumActive)
+{
+	const int32 PreviousNumActive = m_Simulation.GetNumActive();
+	m_Simulation.SetNumActive(NumActive);
+	NumActive = m_Simulation.GetNumActive();
+
+	const int32 Last = FMath::Min(FMath::Max(PreviousNumActive, NumActive), SpawnedBoids.Num());
+	for (int32 i = FMath::Min(PreviousNumActive, NumActive); i < Last; i++)
+	{
+		UpdateBoidActivation(i);
+	}
+}
+
+void ABoidsManager::GetRenderState(int32 Index, FVector& OutPosition, FVector& OutVelocity) const
+{
+	const FBoidsFlockState& State = m_Simulation.GetState();
+	const FBoidsFlockState& Previous = m_Simulation.GetPreviousState();
+
+	if (!m_bFixedTimestep || !Previous.Positions.IsValidIndex(Index))
+	{
+		OutPosition = State.Positions[Index];
+		OutVelocity = State.Velocities[Index];
+	}
+	else
+	{
+		OutPosition = FMath::Lerp(Previous.Positions[Index], State.Positions[Index], m_InterpolationAlpha);
+		OutVelocity = FMath::Lerp(Previous.Velocities[Index], State.Velocities[Index], m_InterpolationAlpha);
+	}
+
+	// A replicated client shows its boids sliding to the keyframe rather than jumping to it
+	if (m_CorrectionAlpha > 0.0f && m_Corrections.IsValidIndex(Index))
+	{
+		OutPosition += m_Corrections[Index] * m_CorrectionAlpha;
+	}
+}
+
+void ABoidsManager::RebuildSpatialGrid()
+{
+	FBoidsFlockState& State = m_Simulation.GetState();
+	for (int32 i = 0; i < SpawnedBoids.Num() && i < State.Num(); i++)
+	{
+		if (SpawnedBoids[i])
+		{
+			State.Positions[i] = SpawnedBoids[i]->GetActorLocation();
+		}
+	}
+
+	m_Simulation.RebuildGrid();
+}
+
+int32 ABoidsManager::AddInfluence(FVector Location, float Radius, float Strength, float InnerRadius, float Falloff)
+{
+	FBoidsInfluenceSource& Source = m_InfluenceSources.AddDefaulted_GetRef();
+	Source.Id = m_NextInfluenceId++;
+	Source.Influence.Position = Location;
+	Source.Influence.Radius = Radius;
+	Source.Influence.InnerRadius = FMath::Clamp(InnerRadius, 0.0f, Radius);
+	Source.Influence.Strength = Strength;
+	Source.Influence.Falloff = FMath::Max(Falloff, 0.0f);
+	return Source.Id;
+}
+
+int32 ABoidsManager::AddActorInfluence(AActor* Actor, float Radius, float Strength, float InnerRadius, float Falloff)
+{
+	if (!Actor)
+	{
+		UE_LOG(LogTemp, Error, TEXT("AddActorInfluence needs an actor to follow."));
+		return 0;
+	}
+
+	// Boid actors steer on their own and never read the sources, they would only pile up
+	if (!m_bBatchSimulation)
+	{
+		return 0;
+	}
+
+	const int32 InfluenceId = AddInfluence(Actor->GetActorLocation(), Radius, Strength, InnerRadius, Falloff);
+	FBoidsInfluenceSource& Source = m_InfluenceSources.Last();
+	Source.Actor = Actor;
+	Source.bFollowsActor = true;
+	return InfluenceId;
+}
+
+void ABoidsManager::MoveInfluence(int32 InfluenceId, FVector Location)
+{
+	if (FBoidsInfluenceSource* Source = m_InfluenceSources.FindByPredicate([InfluenceId](const FBoidsInfluenceSource& Candidate) { return Candidate.Id == InfluenceId; }))
+	{
+		Source->Influence.Position = Location;
+	}
+}
+
+void ABoidsManager::RemoveInfluence(int32 InfluenceId)
+{
+	m_InfluenceSources.RemoveAll([InfluenceId](const FBoidsInfluenceSource& Source) { return Source.Id == InfluenceId; });
+}
+
+void ABoidsManager::AddActorInfluenceToWorld(AActor* Actor, float Radius, float Strength)
+{
+	if (!Actor || !Actor->GetWorld())
+	{
+		return;
+	}
+
+	for (TActorIterator<ABoidsManager> It(Actor->GetWorld()); It; ++It)
+	{
+		It->AddActorInfluence(Actor, Radius, Strength);
+	}
+}
+
+void ABoidsManager::UpdateInfluences()
+{
+	// Nothing to hand over twice once the last source is gone
+	if (m_InfluenceSources.Num() == 0 && m_Influences.Num() == 0)
+	{
+		return;
+	}
+
+	m_Influences.Reset(m_InfluenceSources.Num());
+	for (FBoidsInfluenceSource& Source : m_InfluenceSources)
+	{
+		if (Source.bFollowsActor)
+		{
+			Source.Influence.Position = Source.Actor->GetActorLocation();
+		}
+		m_Influences.Add(Source.Influence);
+	}
+
+	m_Simulation.SetInfluences(m_Influences);
+	m_MassFlock.Influences.SetSources(m_Influences);
+}
+
+void ABoidsManager::GatherViewLocations(TArray<FVector, TInlineAllocator<4>>& OutViewLocations) const
+{
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APlayerController* PlayerController = It->Get())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			OutViewLocations.Add(ViewLocation);
+		}
+	}
+}
+
+bool ABoidsManager::UpdateSleep(float DeltaTime)
+{
+	TArray<FVector, TInlineAllocator<4>> ViewLocations;
+	GatherViewLocations(ViewLocations);
+
+	const FBoidsFlockState& State = m_Simulation.GetState();
+	TArrayView<EBoidsLod> Lods = m_Simulation.GetLods();
+	const int32 NumActive = FMath::Min(m_Simulation.GetNumActive(), Lods.Num());
+
+	// Every active boid joins the cell it sits in, an asleep boid does not move so its cell keeps its sleep state
+	for (TPair<FIntVector, FBoidsSleepCluster>& Pair : m_SleepClusters)
+	{
+		Pair.Value.NumBoids = 0;
+	}
+	m_BoidSleepCells.SetNumUninitialized(NumActive, EAllowShrinking::No);
+	for (int32 i = 0; i < NumActive; i++)
+	{
+		m_BoidSleepCells[i] = GetSleepCell(State.Positions[i]);
+		m_SleepClusters.FindOrAdd(m_BoidSleepCells[i]).NumBoids++;
+	}
+
+	int32 NumAsleep = 0;
+	float WakeTime = 0.0f;
+	bool bAnyWakes = false;
+	for (TMap<FIntVector, FBoidsSleepCluster>::TIterator It = m_SleepClusters.CreateIterator(); It; ++It)
+	{
+		FBoidsSleepCluster& Cluster = It.Value();
+		if (Cluster.NumBoids == 0)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		// Without any view nothing can tell a cluster is irrelevant, it stays awake
+		// The wake distance is a tenth closer, so a viewer at the limit does not toggle the cluster every frame
+		const FBox CellBounds(FVector(It.Key()) * m_SleepClusterSize, FVector(It.Key() + FIntVector(1)) * m_SleepClusterSize);
+		const double Distance = Cluster.bAsleep ? m_SleepDistance * 0.9 : m_SleepDistance;
+		bool bAsleep = ViewLocations.Num() > 0;
+		for (const FVector& ViewLocation : ViewLocations)
+		{
+			bAsleep &= CellBounds.ComputeSquaredDistanceToPoint(ViewLocation) > FMath::Square(Distance);
+		}
+
+		Cluster.bWakes = Cluster.bAsleep && !bAsleep;
+		if (Cluster.bWakes)
+		{
+			WakeTime = FMath::Max(WakeTime, Cluster.SleepTime);
+			bAnyWakes = true;
+		}
+
+		Cluster.bAsleep = bAsleep;
+		Cluster.SleepTime = bAsleep ? Cluster.SleepTime + DeltaTime : 0.0f;
+		NumAsleep += bAsleep ? Cluster.NumBoids : 0;
+	}
+
+	// Waking boids are stepped alone over the longest time any of them slept, every other boid is held still meanwhile
+	if (bAnyWakes && m_bBatchSimulation && m_MaxWakeSteps > 0)
+	{
+		for (int32 i = 0; i < NumActive; i++)
+		{
+			Lods[i] = m_SleepClusters.FindChecked(m_BoidSleepCells[i]).bWakes ? EBoidsLod::Near : EBoidsLod::Asleep;
+		}
+		FastForward(WakeTime);
+	}
+
+	// Asleep boids leave the simulation through their tier, UpdateLods sorts the others afterwards
+	for (int32 i = 0; i < NumActive; i++)
+	{
+		const bool bAsleep = m_SleepClusters.FindChecked(m_BoidSleepCells[i]).bAsleep;
+		if (bAsleep != (Lods[i] == EBoidsLod::Asleep))
+		{
+			Lods[i] = bAsleep ? EBoidsLod::Asleep : EBoidsLod::Near;
+			if (SpawnedBoids.IsValidIndex(i))
+			{
+				UpdateBoidActivation(i);
+			}
+		}
+	}
+
+	const bool bFlockAsleep = NumActive > 0 && NumAsleep == NumActive;
+	if (bFlockAsleep != m_bAsleep)
+	{
+		if (bFlockAsleep)
+		{
+			UE_LOG(LogTemp, Log, TEXT("%s falls asleep, no viewer within %.0f."), *GetName(), m_SleepDistance);
+
+			// A sleeping flock reads no ray, the ones in flight would be stale when it wakes
+			m_PendingTraces.Reset();
+		}
+		else
+		{
+			UE_LOG(LogTemp, Log, TEXT("%s wakes up, %d of %d boids still asleep."), *GetName(), NumAsleep, NumActive);
+		}
+		m_bAsleep = bFlockAsleep;
+	}
+	return m_bAsleep;
+}
+
+FIntVector ABoidsManager::GetSleepCell(const FVector& Position) const
+{
+	return FIntVector(
+		FMath::FloorToInt32(Position.X / m_SleepClusterSize),
+		FMath::FloorToInt32(Position.Y / m_SleepClusterSize),
+		FMath::FloorToInt32(Position.Z / m_SleepClusterSize));
+}
+
+void ABoidsManager::FastForward(float Seconds)
+{
+	// Boid actors carry their own state, they resume where they stopped
+	if (!m_bBatchSimulation || Seconds <= 0.0f || m_MaxWakeSteps <= 0)
+	{
+		return;
+	}
+
+	// A long sleep is cut to the step limit, the flock resumes from a shorter but settled history
+	const float StepTime = m_bFixedTimestep ? 1.0f / m_SimulationRate : 1.0f / 30.0f;
+
+	// The waking boids replay the steps the rest of the flock already ran, the shared step index does not move,
+	// so awake boids keep their streams, the replay its step count and replicated clients their alignment with the server
+	const int32 NumSteps = FMath::Min(FMath::CeilToInt32(Seconds / StepTime), m_MaxWakeSteps);
+	StepWithoutAvoidance(NumSteps, StepTime, m_Simulation.GetStepIndex() - uint32(NumSteps));
+
+	// Rendering starts from the fast-forwarded state instead of blending from the frozen one
+	m_Simulation.CopyStateToPrevious();
+}
+
+void ABoidsManager::UpdateLods()
+{
+	TArray<FVector, TInlineAllocator<4>> ViewLocations;
+	GatherViewLocations(ViewLocations);
+
+	const FBoidsFlockState& State = m_Simulation.GetState();
+	TArrayView<EBoidsLod> Lods = m_Simulation.GetLods();
+	const double MidDistanceSquared = FMath::Square(m_LodMidDistance);
+	const double FarDistanceSquared = FMath::Square(m_LodFarDistance);
+
+	for (int32 i = 0; i < m_Simulation.GetNumActive() && i < Lods.Num(); i++)
+	{
+		// Asleep boids keep their tier until their cluster wakes
+		if (Lods[i] == EBoidsLod::Asleep)
+		{
+			continue;
+		}
+
+		// Without any view the whole flock stays at full detail
+		double ClosestDistanceSquared = ViewLocations.Num() > 0 ? TNumericLimits<double>::Max() : 0.0;
+		for (const FVector& ViewLocation : ViewLocations)
+		{
+			ClosestDistanceSquared = FMath::Min(ClosestDistanceSquared, FVector::DistSquared(ViewLocation, State.Positions[i]));
+		}
+
+		Lods[i] = ClosestDistanceSquared >= FarDistanceSquared ? EBoidsLod::Far
+			: ClosestDistanceSquared >= MidDistanceSquared ? EBoidsLod::Mid
+			: EBoidsLod::Near;
+	}
+}
+
+void ABoidsManager::GatherObstacleAvoidance()
+{
+	BOIDS_SCOPE_CYCLE_COUNTER(STAT_BoidsObstacleAvoidance);
+
+	const FBoidsFlockState& State = m_Simulation.GetState();
+	const float AvoidanceWeight = m_Simulation.GetSettings().AvoidanceWeight;
+
+	m_Avoidance.SetNum(m_Simulation.GetNumActive());
+
+	// The rays feed the step about to run, the counter still holds its index
+	const uint32 StepIndex = m_Simulation.GetStepIndex();
+	int32 NumTraces = 0;
+
+	for (int32 i = 0; i < m_Avoidance.Num(); i++)
+	{
+		FBoidsAvoidance& Avoidance = m_Avoidance[i];
+		Avoidance = FBoidsAvoidance();
+
+		// Boids that are not stepped this frame or are too far to avoid anything cast no ray
+		if (!m_Simulation.NeedsAvoidance(i, StepIndex))
+		{
+			continue;
+		}
+		NumTraces += FBoidsAvoidance::NumRays;
+
+		const FVector Start = State.Positions[i];
+		const FVector Forward = State.Velocities[i].GetSafeNormal();
+
+		FCollisionQueryParams CollisionParams;
+		if (SpawnedBoids.IsValidIndex(i))
+		{
+			CollisionParams.AddIgnoredActor(SpawnedBoids[i]);
+		}
+
+		for (int32 RayIndex = 0; RayIndex < FBoidsAvoidance::NumRays; RayIndex++)
+		{
+			FHitResult HitResult;
+			const FVector End = Start + FRotator(0.0f, FBoidsAvoidance::RayYaws[RayIndex], 0.0f).RotateVector(Forward) * FBoidsAvoidance::RayLength;
+
+			if (GetWorld()->LineTraceSingleByChannel(HitResult, Start, End, ECC_Visibility, CollisionParams))
+			{
+				Avoidance.AddHit(RayIndex, Start, HitResult.ImpactPoint, AvoidanceWeight);
+			}
+		}
+
+		Avoidance.Finalize();
+	}
+
+	INC_DWORD_STAT_BY(STAT_BoidsTracesIssued, NumTraces);
+	TRACE_COUNTER_SET(BoidsTracesIssuedCounter, NumTraces);
+}
+
+void ABoidsManager::ConsumeObstacleTraces()
+{
+	BOIDS_SCOPE_CYCLE_COUNTER(STAT_BoidsObstacleAvoidance);
+
+	const int32 NumBoids = m_Simulation.GetNumActive();
+	const float AvoidanceWeight = m_Simulation.GetSettings().AvoidanceWeight;
+
+	m_Avoidance.SetNum(NumBoids);
+
+	for (int32 i = 0; i < NumBoids; i++)
+	{
+		FBoidsAvoidance& Avoidance = m_Avoidance[i];
+		Avoidance = FBoidsAvoidance();
+
+		for (int32 RayIndex = 0; RayIndex < FBoidsAvoidance::NumRays; RayIndex++)
+		{
+			const int32 TraceIndex = i * FBoidsAvoidance::NumRays + RayIndex;
+
+			FTraceDatum TraceDatum;
+			if (!m_PendingTraces.IsValidIndex(TraceIndex) || !GetWorld()->QueryTraceData(m_PendingTraces[TraceIndex], TraceDatum))
+			{
+				continue;
+			}
+
+			if (TraceDatum.OutHits.Num() > 0 && TraceDatum.OutHits[0].bBlockingHit)
+			{
+				Avoidance.AddHit(RayIndex, TraceDatum.Start, TraceDatum.OutHits[0].ImpactPoint, AvoidanceWeight);
+			}
+		}
+
+		Avoidance.Finalize();
+	}
+}
+
+void ABoidsManager::IssueObstacleTraces()
+{
+	BOIDS_SCOPE_CYCLE_COUNTER(STAT_BoidsObstacleAvoidance);
+
+	const FBoidsFlockState& State = m_Simulation.GetState();
+	const int32 NumBoids = m_Simulation.GetNumActive();
+
+	m_PendingTraces.SetNum(NumBoids * FBoidsAvoidance::NumRays);
+
+	// Issued after the last step of the frame, the rays feed the next step whose index the counter already holds
+	const uint32 StepIndex = m_Simulation.GetStepIndex();
+	int32 NumTraces = 0;
+
+	// Every ray of the flock goes through the async trace batch, the world runs them after this tick
+	for (int32 i = 0; i < NumBoids; i++)
+	{
+		// Boids that are not stepped next frame or are too far to avoid anything cast no ray
+		if (!m_Simulation.NeedsAvoidance(i, StepIndex))
+		{
+			for (int32 RayIndex = 0; RayIndex < FBoidsAvoidance::NumRays; RayIndex++)
+			{
+				m_PendingTraces[i * FBoidsAvoidance::NumRays + RayIndex] = FTraceHandle();
+			}
+			continue;
+		}
+		NumTraces += FBoidsAvoidance::NumRays;
+
+		const FVector Start = State.Positions[i];
+		const FVector Forward = State.Velocities[i].GetSafeNormal();
+
+		FCollisionQueryParams CollisionParams;
+		if (SpawnedBoids.IsValidIndex(i))
+		{
+			CollisionParams.AddIgnoredActor(SpawnedBoids[i]);
+		}
+
+		for (int32 RayIndex = 0; RayIndex < FBoidsAvoidance::NumRays; RayIndex++)
+		{
+			const FVector End = Start + FRotator(0.0f, FBoidsAvoidance::RayYaws[RayIndex], 0.0f).RotateVector(Forward) * FBoidsAvoidance::RayLength;
+			m_PendingTraces[i * FBoidsAvoidance::NumRays + RayIndex] = GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, End, ECC_Visibility, CollisionParams);
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_BoidsTracesIssued, NumTraces);
+	TRACE_COUNTER_SET(BoidsTracesIssuedCounter, NumTraces);
+}
+
+void ABoidsManager::WriteBackTransforms()
+{
+	BOIDS_SCOPE_CYCLE_COUNTER(STAT_BoidsWriteBack);
+
+	for (int32 i = 0; i < SpawnedBoids.Num() && i < m_Simulation.GetNumActive(); i++)
+	{
+		if (ABoids* Boid = SpawnedBoids[i])
+		{
+			FVector Position;
+			FVector Velocity;
+			GetRenderState(i, Position, Velocity);
+			Boid->SetActorLocationAndRotation(Position, Velocity.Rotation(), false, nullptr, ETeleportType::TeleportPhysics);
+		}
+	}
+}
+
+void ABoidsManager::BakeDistanceField()
+{
+	if (!m_DistanceField)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Assign a distance field asset to the BoidsManager before baking."));
+		return;
+	}
+
+	// Distances further than twice the ray length never steer a boid
+	const FBox Bounds = FBox::BuildAABB(GetActorLocation(), m_DistanceFieldExtent);
+	m_DistanceField->Bake(GetWorld(), Bounds, m_DistanceFieldVoxelSize, FBoidsAvoidance::RayLength * 2.0f);
+}
+
+void ABoidsManager::InitializeInstances()
+{
+	const ABoids* BoidDefaults = BoidClass->GetDefaultObject<ABoids>();
+	UStaticMeshComponent* BoidMesh = BoidDefaults->BoidsMesh;
+
+	if (m_AnimatedMesh)
+	{
+		// The animated mesh keeps its own vertex animation materials and scale
+		InstancedMesh->SetStaticMesh(m_AnimatedMesh);
+		InstancedMesh->SetNumCustomDataFloats(UBoidsInstancedMeshComponent::NumAnimationFloats);
+		m_InstanceScale = FVector::OneVector;
+
+		// Phases are spread along the golden ratio so neighbors never flap in sync
+		m_AnimationPhases.SetNumUninitialized(m_Simulation.GetState().Num());
+		for (int32 i = 0; i < m_AnimationPhases.Num(); i++)
+		{
+			m_AnimationPhases[i] = FMath::Frac(i * 0.618034f);
+		}
+	}
+	else
+	{
+		InstancedMesh->SetStaticMesh(BoidMesh->GetStaticMesh());
+		for (int32 i = 0; i < BoidMesh->GetNumMaterials(); i++)
+		{
+			InstancedMesh->SetMaterial(i, BoidMesh->GetMaterial(i));
+		}
+		m_InstanceScale = BoidMesh->GetRelativeScale3D();
+	}
+
+	// Pooled boids get an instance too, so spawning never adds instances at runtime
+	m_InstanceTransforms.SetNum(m_Simulation.GetState().Num());
+	for (int32 i = 0; i < m_InstanceTransforms.Num(); i++)
+	{
+		m_InstanceTransforms[i] = GetInstanceTransform(i);
+	}
+	m_NumVisibleInstances = m_Simulation.GetNumActive();
+
+	InstancedMesh->ClearInstances();
+	InstancedMesh->AddInstances(m_InstanceTransforms, false, true);
+}
+
+FTransform ABoidsManager::GetInstanceTransform(int32 Index) const
+{
+	if (Index >= m_Simulation.GetNumActive())
+	{
+		return FTransform(FQuat::Identity, GetActorLocation(), FVector::ZeroVector);
+	}
+
+	FVector Position;
+	FVector Velocity;
+	GetRenderState(Index, Position, Velocity);
+	return FTransform(Velocity.ToOrientationQuat(), Position, m_InstanceScale);
+}
+
+void ABoidsManager::WriteBackInstances(float DeltaTime)
+{
+	BOIDS_SCOPE_CYCLE_COUNTER(STAT_BoidsWriteBack);
+
+	// Boids returned to the pool since the last write back are collapsed once, then skipped
+	const int32 NumActive = m_Simulation.GetNumActive();
+	const int32 NumInstances = FMath::Min(FMath::Max(NumActive, m_NumVisibleInstances), m_InstanceTransforms.Num());
+	m_NumVisibleInstances = NumActive;
+
+	// The flock extent is gathered in the same loop, so bounds never walk the instances again
+	FBox FlockBounds(ForceInit);
+	int32 FirstDirty = INDEX_NONE;
+	int32 LastDirty = INDEX_NONE;
+
+	const int32 NumAnimated = FMath::Min(NumActive, m_AnimationPhases.Num());
+	const float MaxSpeed = m_Simulation.GetSettings().MaxSpeed;
+
+	for (int32 i = 0; i < NumInstances; i++)
+	{
+		const FTransform Transform = GetInstanceTransform(i);
+		if (i < NumActive)
+		{
+			FlockBounds += Transform.GetLocation();
+		}
+
+		if (!Transform.Equals(m_InstanceTransforms[i], KINDA_SMALL_NUMBER))
+		{
+			m_InstanceTransforms[i] = Transform;
+			FirstDirty = FirstDirty == INDEX_NONE ? i : FirstDirty;
+			LastDirty = i;
+		}
+
+		// The phase integrates the speed, so a boid changing speed never jumps in its cycle
+		if (i < NumAnimated)
+		{
+			FVector Position;
+			FVector Velocity;
+			GetRenderState(i, Position, Velocity);
+
+			const float Speed = MaxSpeed > 0.0f ? FMath::Min(Velocity.Size() / MaxSpeed, 1.0f) : 0.0f;
+			m_AnimationPhases[i] = FMath::Frac(m_AnimationPhases[i] + DeltaTime * m_AnimationCycleRate * Speed);
+			InstancedMesh->SetAnimationData(i, m_AnimationPhases[i], Speed);
+		}
+	}
+
+	// Only a moving boid advances its cycle, so the custom data always rides on the batched transform update
+	if (FirstDirty == INDEX_NONE)
+	{
+		return;
+	}
+
+	m_DirtyInstanceTransforms.Reset(LastDirty - FirstDirty + 1);
+	m_DirtyInstanceTransforms.Append(&m_InstanceTransforms[FirstDirty], LastDirty - FirstDirty + 1);
+
+	const float MeshExtent = InstancedMesh->GetStaticMesh() ? InstancedMesh->GetStaticMesh()->GetBounds().SphereRadius * m_InstanceScale.GetMax() : 0.0f;
+	InstancedMesh->SetFlockBounds(FlockBounds.ExpandBy(MeshExtent));
+	InstancedMesh->BatchUpdateInstancesTransforms(FirstDirty, m_DirtyInstanceTransforms, true, true, true);
+}
+
+void ABoidsManager::FindNeighbors(int32 BoidIndex, const FVector& Location, float Radius, int32 MaxNeighbors, TArray<ABoids*>& OutNeighbors) const
+{
+	if (MaxNeighbors > 0)
+	{
+		FBoidsNearestNeighbors Nearest;
+		Nearest.Reset(MaxNeighbors);
+		m_Simulation.GetGrid().FindNearest(Location, Radius, BoidIndex, Nearest);
+
+		for (const FBoidsNearestNeighbors::FEntry& Entry : Nearest.Entries)
+		{
+			if (SpawnedBoids.IsValidIndex(Entry.Index) && SpawnedBoids[Entry.Index])
+			{
+				OutNeighbors.Add(SpawnedBoids[Entry.Index]);
+			}
+		}
+		return;
+	}
+
+	m_Simulation.GetGrid().ForEachInRadius(Location, Radius, [this, BoidIndex, &OutNeighbors](int32 Index, const FVector&)
+	{
+		if (Index != BoidIndex && SpawnedBoids.IsValidIndex(Index) && SpawnedBoids[Index])
+		{
+			OutNeighbors.Add(SpawnedBoids[Index]);
+		}
+	});
+}
+
@@ -1,41 +1,636 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "BeBoids/Entities/Boids.h"
-#include "GameFramework/Actor.h"
-#include "BoidsManager.generated.h"
-
-UCLASS()
-class BEBOIDS_API ABoidsManager : public AActor
-{
-	GENERATED_BODY()
-
-public:
-	// Sets default values for this actor's properties
-	ABoidsManager();
-
-protected:
-	// Called when the game starts or when spawned
-	virtual void BeginPlay() override;
-
-public:
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
-
-	UPROPERTY()
-	TArray<ABoids*> SpawnedBoids;
-
-	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Boids")
-	int m_NumBoids = 100;
-
-	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Boids")
-	FVector m_SpawnVolume;
-
-	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Boids")
-	ABoids* BoidsRef = Cast<ABoids>(ABoids::StaticClass());
-
-	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Boids")
-	TSubclassOf<ABoids> BoidClass;
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "BeBoids/Entities/Boids.h"
+#include "BeBoids/Entities/Components/BoidsInstancedMeshComponent.h"
+#include "BeBoids/Entities/Mass/BoidsMassProcessors.h"
+#include "BoidsFlockSimulation.h"
+#include "BoidsInfluence.h"
+#include "BoidsKeyframe.h"
+#include "BoidsReplay.h"
+#include "BoidsSnapshot.h"
+#include "BeBoids/Entities/Obstacles/BoidsDistanceFieldAsset.h"
+#include "Engine/NetSerialization.h"
+#include "GameFramework/Actor.h"
+#include "MassEntityTypes.h"
+#include "MassProcessingTypes.h"
+#include "WorldCollision.h"
+#include "BoidsManager.generated.h"
+
+/**
+ * FBoidsFrameTimings holds the time spent in each phase of the last manager tick, in milliseconds.
+ */
+struct FBoidsFrameTimings
+{
+	// Spatial grid rebuild and neighbor gathering
+	double NeighborSearchMs = 0.0;
+
+	// Rule evaluation and integration
+	double SteeringMs = 0.0;
+
+	// Obstacle avoidance scene queries
+	double AvoidanceMs = 0.0;
+
+	// Transforms written back to the actors or instances
+	double WriteBackMs = 0.0;
+};
+
+/**
+ * FBoidsSpawnState holds the start position and velocity of every pooled boid,
+ * drawn from the spawn stream, and the stream as it was left by the draws.
+ */
+struct FBoidsSpawnState
+{
+	// Start position of each boid, inside the spawn volume
+	TArray<FVector> Positions;
+
+	// Start velocity of each boid
+	TArray<FVector> Velocities;
+
+	// Spawn stream after the draws
+	FRandomStream Random;
+
+	// Draws NumBoids positions within Extent of Center then as many headings moving at Speed
+	void Generate(FRandomStream& InRandom, int32 NumBoids, const FVector& Center, const FVector& Extent, float Speed);
+};
+
+/**
+ * FBoidsInfluenceSource is one attractor or repulsor registered on the manager,
+ * either placed in the world or following an actor.
+ */
+struct FBoidsInfluenceSource
+{
+	// Handle given back to the caller
+	int32 Id = 0;
+
+	// Source as applied to the flock
+	FBoidsInfluence Influence;
+
+	// Actor the source follows, the source goes away with it
+	TWeakObjectPtr<AActor> Actor;
+
+	// Whether the source follows Actor
+	bool bFollowsActor = false;
+};
+
+/**
+ * FBoidsSleepCluster is one cell of the coarse grid a flock is split into for
+ * sleeping, its boids freeze while every viewer is far from the cell.
+ */
+struct FBoidsSleepCluster
+{
+	// Active boids in the cell this frame
+	int32 NumBoids = 0;
+
+	// Whether the boids of the cell are frozen
+	bool bAsleep = false;
+
+	// Whether the cell wakes this frame
+	bool bWakes = false;
+
+	// Seconds the cell has slept so far
+	float SleepTime = 0.0f;
+};
+
+/**
+ * FBoidsFlockKeyframe is one slice of the replicated state of a flock: the seed
+ * and step of the server simulation and a bounded run of its active boids
+ * encoded by FBoidsKeyframe. Successive keyframes carry successive slices, so
+ * one update never grows with the flock. Clients simulate the flock themselves
+ * and only correct the boids of each slice.
+ */
+USTRUCT()
+struct FBoidsFlockKeyframe
+{
+	GENERATED_BODY()
+
+	// Most boids a slice carries, keeps one update well within the partial bunch limits and a corrupted count from allocating
+	static constexpr int32 MaxSliceBoids = 2048;
+
+	// Seed of the server flock
+	UPROPERTY()
+	uint32 Seed = 0;
+
+	// Step index of the server simulation when the slice was taken
+	UPROPERTY()
+	uint32 StepIndex = 0;
+
+	// Active boids of the server flock
+	UPROPERTY()
+	uint32 NumBoids = 0;
+
+	// Index of the first boid of the slice
+	UPROPERTY()
+	uint32 FirstBoid = 0;
+
+	// Boids of the slice, FBoidsKeyframe::BoidSize bytes each
+	UPROPERTY()
+	TArray<uint8> Boids;
+
+	// Sends the boids as one raw block instead of one property per byte
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FBoidsFlockKeyframe> : public TStructOpsTypeTraitsBase2<FBoidsFlockKeyframe>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+UENUM(BlueprintType)
+enum class EBoidsReplayMode : uint8
+{
+	// Simulates the flock without recording it
+	None,
+
+	// Simulates the flock and streams every step to the replay file
+	Record,
+
+	// Drives the flock from the replay file without simulating
+	Playback
+};
+
+UENUM(BlueprintType)
+enum class EBoidsBackend : uint8
+{
+	// Steps the flock with FBoidsFlockSimulation
+	FlockSimulation,
+
+	// Stores the boids as Mass entities stepped by the flock processors
+	MassEntity
+};
+
+UCLASS()
+class BEBOIDS_API ABoidsManager : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this actor's properties
+	ABoidsManager();
+
+protected:
+	// Makes the manager a replicated actor only when its flock replicates
+	virtual void PostInitProperties() override;
+
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+
+	// Called when the manager is removed from the world, ends the replay recording
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+public:
+	// Replicates the flock keyframe
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	// Called every frame
+	virtual void Tick(float DeltaTime) override;
+
+	UPROPERTY()
+	TArray<ABoids*> SpawnedBoids;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Boids")
+	int m_NumBoids = 100;
+
+	// Boids allocated at BeginPlay, the ones beyond m_NumBoids wait hidden for SpawnBoids, zero sizes the pool to m_NumBoids
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Pool", meta = (ClampMin = "0"))
+	int32 m_PoolSize = 0;
+
+	// Activates up to Count pooled boids within Radius of Location, returns how many joined the flock
+	UFUNCTION(BlueprintCallable, Category = "Boids|Pool")
+	int32 SpawnBoids(int32 Count, FVector Location, float Radius);
+
+	// Returns up to Count boids to the pool, the last activated first, returns how many left the flock
+	UFUNCTION(BlueprintCallable, Category = "Boids|Pool")
+	int32 DespawnBoids(int32 Count);
+
+	// Spawns in the spawn volume or despawns boids until the flock counts NumBoids boids, within the pool size
+	UFUNCTION(BlueprintCallable, Category = "Boids|Pool")
+	void SetPopulation(int32 NumBoids);
+
+	// Number of boids currently in the flock
+	UFUNCTION(BlueprintPure, Category = "Boids|Pool")
+	int32 GetNumActiveBoids() const { return m_Simulation.GetNumActive(); }
+
+	// Number of boid slots ready to join the flock, actors still waiting for their time slice excluded
+	UFUNCTION(BlueprintPure, Category = "Boids|Pool")
+	int32 GetPoolCapacity() const { return m_bInstancedRendering ? m_Simulation.GetState().Num() : FMath::Min(m_Simulation.GetState().Num(), SpawnedBoids.Num()); }
+
+	// Milliseconds per frame spent spawning boid actors, the spawn state is drawn on a worker and the flock grows over the first frames, zero spawns everything in BeginPlay
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Pool", meta = (ClampMin = "0.0", Units = "ms"))
+	float m_SpawnBudgetMs = 0.0f;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Boids")
+	FVector m_SpawnVolume;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Boids")
+	ABoids* BoidsRef = Cast<ABoids>(ABoids::StaticClass());
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Boids")
+	TSubclassOf<ABoids> BoidClass;
+
+	// Seed of the spawn positions and of every boid random stream, zero picks a new seed each run
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Boids")
+	int32 m_Seed = 0;
+
+	// Records the batch simulation to m_ReplayFile or plays it back from there
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Replay")
+	EBoidsReplayMode m_ReplayMode = EBoidsReplayMode::None;
+
+	// Replay file, relative to the project Saved directory
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Replay", meta = (EditCondition = "m_ReplayMode != EBoidsReplayMode::None"))
+	FString m_ReplayFile = TEXT("Replays/Flock.boidsreplay");
+
+	// Sends the server flock to the clients as periodic keyframes, clients simulate it in between and correct their drift on each one, implies the batch simulation and the fixed timestep
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Replication")
+	bool m_bReplicateFlock = false;
+
+	// Seconds between two keyframes sent by the server
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Replication", meta = (EditCondition = "m_bReplicateFlock", ClampMin = "0.05", Units = "s"))
+	float m_KeyframeInterval = 0.5f;
+
+	// Most boids one keyframe carries, 8 bytes each, a larger flock is sent over several keyframes one slice at a time
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Replication", meta = (EditCondition = "m_bReplicateFlock", ClampMin = "1", ClampMax = "2048"))
+	int32 m_KeyframeSliceSize = 1024;
+
+	// Half size of the box around the manager the keyframe positions are quantized in, 16 bits per axis
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Replication", meta = (EditCondition = "m_bReplicateFlock"))
+	FVector m_ReplicationExtent = FVector(10000.0f, 10000.0f, 5000.0f);
+
+	// Seconds over which a client blends out the visual jump of a keyframe correction
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Replication", meta = (EditCondition = "m_bReplicateFlock", ClampMin = "0.0", Units = "s"))
+	float m_CorrectionTime = 0.25f;
+
+	// Most fixed steps a client runs to bring a late keyframe up to its own step
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Replication", meta = (EditCondition = "m_bReplicateFlock", ClampMin = "0"))
+	int32 m_MaxCatchUpSteps = 8;
+
+	// Flock snapshot relative to the project Saved directory, restored at BeginPlay instead of the random spawn when it exists
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Snapshot")
+	FString m_SnapshotFile;
+
+	// Saves the current flock to m_SnapshotFile, to warm start the next runs from it
+	UFUNCTION(BlueprintCallable, CallInEditor, Category = "Boids|Snapshot")
+	void SaveSnapshot();
+
+	// Representation the batch simulation steps, Mass boids are rendered through the instanced mesh
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Simulation")
+	EBoidsBackend m_Backend = EBoidsBackend::FlockSimulation;
+
+	// Steps the whole flock from the manager instead of ticking every boid actor
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Simulation")
+	bool m_bBatchSimulation = false;
+
+	// Spreads the batch simulation over the worker threads
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Simulation", meta = (EditCondition = "m_bBatchSimulation"))
+	bool m_bParallelSimulation = true;
+
+	// Steps the flock at a fixed rate with a single integration per step, rendering interpolates between the last two steps, implies the batch simulation
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Simulation")
+	bool m_bFixedTimestep = false;
+
+	// Steps per second of the fixed timestep simulation
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Simulation", meta = (EditCondition = "m_bFixedTimestep", ClampMin = "1.0", Units = "Hz"))
+	float m_SimulationRate = 30.0f;
+
+	// Most fixed steps run in one frame, time beyond it is dropped after a hitch
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Simulation", meta = (EditCondition = "m_bFixedTimestep", ClampMin = "1"))
+	int32 m_MaxSimulationSteps = 4;
+
+	// Milliseconds the batch step may spend on the rules each frame, boids left over are extrapolated and stepped first next frame, zero for no limit
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Simulation", meta = (EditCondition = "m_bBatchSimulation", ClampMin = "0.0", Units = "ms"))
+	float m_SimulationBudgetMs = 0.0f;
+
+	// Spawns boids without physics body or overlap events, neighbors only come from the spatial grid
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Simulation")
+	bool m_bCollisionFreeBoids = false;
+
+	// Issues the obstacle avoidance rays as one asynchronous batch, consumed on the next frame
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Simulation", meta = (EditCondition = "m_bBatchSimulation"))
+	bool m_bAsyncObstacleTraces = true;
+
+	// Baked static obstacle field, replaces the avoidance traces of the batch simulation and of the boid actors when set
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Obstacles")
+	UBoidsDistanceFieldAsset* m_DistanceField = nullptr;
+
+	// Half size of the volume around the manager baked into the distance field
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Obstacles")
+	FVector m_DistanceFieldExtent = FVector(2000.0f, 2000.0f, 1000.0f);
+
+	// Distance between two distance field samples
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Obstacles", meta = (ClampMin = "10.0"))
+	float m_DistanceFieldVoxelSize = 50.0f;
+
+	// Samples the static collision around the manager into m_DistanceField
+	UFUNCTION(CallInEditor, Category = "Boids|Obstacles")
+	void BakeDistanceField();
+
+	// Renders the flock through one instanced mesh instead of spawning boid actors, implies the batch simulation
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Rendering")
+	bool m_bInstancedRendering = false;
+
+	// Mesh with a baked vertex animation texture rendered instead of the boid mesh, its material reads the cycle phase and speed ratio from the instance custom data
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Rendering", meta = (EditCondition = "m_bInstancedRendering"))
+	UStaticMesh* m_AnimatedMesh = nullptr;
+
+	// Animation cycles per second of a boid flying at the maximum speed, slower boids flap or swim slower
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Rendering", meta = (EditCondition = "m_AnimatedMesh != nullptr", ClampMin = "0.0", Units = "Hz"))
+	float m_AnimationCycleRate = 2.0f;
+
+	// Instanced mesh rendering every boid when m_bInstancedRendering is set
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Boids|Rendering")
+	UBoidsInstancedMeshComponent* InstancedMesh;
+
+	// Lowers the update rate of the batch simulation for boids far from every player view
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|LOD", meta = (EditCondition = "m_bBatchSimulation"))
+	bool m_bSimulationLod = false;
+
+	// Distance to the closest view beyond which boids are stepped every m_LodMidInterval frames
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|LOD", meta = (EditCondition = "m_bSimulationLod", ClampMin = "0.0"))
+	float m_LodMidDistance = 5000.0f;
+
+	// Distance to the closest view beyond which boids skip obstacle avoidance and sample fewer neighbors
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|LOD", meta = (EditCondition = "m_bSimulationLod", ClampMin = "0.0"))
+	float m_LodFarDistance = 15000.0f;
+
+	// Frames between two steps of a mid range boid, its position is extrapolated in between
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|LOD", meta = (EditCondition = "m_bSimulationLod", ClampMin = "1", ClampMax = "4"))
+	int32 m_LodMidInterval = 2;
+
+	// Frames between two steps of a far boid
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|LOD", meta = (EditCondition = "m_bSimulationLod", ClampMin = "1", ClampMax = "8"))
+	int32 m_LodFarInterval = 4;
+
+	// Neighbors sampled by a far boid, taken from its own grid cell only
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|LOD", meta = (EditCondition = "m_bSimulationLod", ClampMin = "1"))
+	int32 m_LodFarMaxNeighbors = 8;
+
+	// Freezes the boids of every cluster farther than m_SleepDistance from all viewers: no step, no trace and no boid tick
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Sleep")
+	bool m_bSleepWhenIrrelevant = false;
+
+	// Distance from every player view to a cluster cell beyond which its boids sleep, they wake a tenth closer
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Sleep", meta = (EditCondition = "m_bSleepWhenIrrelevant", ClampMin = "0.0"))
+	float m_SleepDistance = 30000.0f;
+
+	// Edge of the cubic cells the flock is split into, each cell sleeps and wakes on its own
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Sleep", meta = (EditCondition = "m_bSleepWhenIrrelevant", ClampMin = "100.0"))
+	float m_SleepClusterSize = 10000.0f;
+
+	// Most steps run to fast-forward the waking clusters of a batch flock over the time they slept
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Boids|Sleep", meta = (EditCondition = "m_bSleepWhenIrrelevant", ClampMin = "0"))
+	int32 m_MaxWakeSteps = 30;
+
+	// Whether every cluster of the flock is asleep, far from all viewers
+	UFUNCTION(BlueprintPure, Category = "Boids|Sleep")
+	bool IsAsleep() const { return m_bAsleep; }
+
+	// Registers an attractor, positive Strength, or a repulsor, negative Strength, at Location, returns its handle
+	UFUNCTION(BlueprintCallable, Category = "Boids|Influence")
+	int32 AddInfluence(FVector Location, float Radius, float Strength, float InnerRadius = 0.0f, float Falloff = 1.0f);
+
+	// Registers a source following Actor until it is destroyed or removed, returns its handle, zero when the flock is not batch simulated
+	UFUNCTION(BlueprintCallable, Category = "Boids|Influence")
+	int32 AddActorInfluence(AActor* Actor, float Radius, float Strength, float InnerRadius = 0.0f, float Falloff = 1.0f);
+
+	// Moves a source added with AddInfluence
+	UFUNCTION(BlueprintCallable, Category = "Boids|Influence")
+	void MoveInfluence(int32 InfluenceId, FVector Location);
+
+	// Unregisters a source
+	UFUNCTION(BlueprintCallable, Category = "Boids|Influence")
+	void RemoveInfluence(int32 InfluenceId);
+
+	// Registers a source following Actor on every manager of its world
+	static void AddActorInfluenceToWorld(AActor* Actor, float Radius, float Strength);
+
+	// Fills OutNeighbors with the boids within Radius of Location, excluding BoidIndex, only the MaxNeighbors closest unless it is zero
+	void FindNeighbors(int32 BoidIndex, const FVector& Location, float Radius, int32 MaxNeighbors, TArray<ABoids*>& OutNeighbors) const;
+
+	// Splits the batch step time between neighbor search and steering, at a small cost per boid
+	void SetPhaseTimings(bool bPhaseTimings) { m_Simulation.SetPhaseTimings(bPhaseTimings); }
+
+	// Time spent in each phase of the last tick
+	const FBoidsFrameTimings& GetLastFrameTimings() const { return m_LastFrameTimings; }
+
+	// Number of boids in the flock
+	int32 GetNumBoids() const { return m_Simulation.GetNumActive(); }
+
+	// Baked obstacle field the flock avoids instead of tracing, null when there is none
+	const FBoidsDistanceField* GetDistanceField() const { return m_Simulation.GetDistanceField(); }
+
+private:
+	// Rebuilds the spatial grid from the current boid locations
+	void RebuildSpatialGrid();
+
+	// Picks the simulation tier of every boid from its distance to the closest player view
+	void UpdateLods();
+
+	// Locations of every player view, remote players included on a server
+	void GatherViewLocations(TArray<FVector, TInlineAllocator<4>>& OutViewLocations) const;
+
+	// Puts each cluster to sleep or wakes it from the distance of its cell to the player views, returns whether the whole flock sleeps
+	bool UpdateSleep(float DeltaTime);
+
+	// Cell of the sleep grid holding Position
+	FIntVector GetSleepCell(const FVector& Position) const;
+
+	// Steps the boids not held asleep over Seconds, at most m_MaxWakeSteps steps ending at the current step index, without avoidance rays
+	void FastForward(float Seconds);
+
+	// Sizes the flock for the spawned pool, spawning every actor unless they are time-sliced
+	void InitializeFlock(FBoidsSpawnState&& SpawnState);
+
+	// Spawns one boid actor at Position and registers it, null when the spawn failed
+	ABoids* SpawnBoidActor(const FVector& Position);
+
+	// Spawns the actors still missing within m_SpawnBudgetMs and activates them
+	void SpawnPendingActors();
+
+	// Shows or hides the actor at Index depending on whether it belongs to the active flock
+	void UpdateBoidActivation(int32 Index);
+
+	// Places the pooled boid at Index with a random heading, before it is activated
+	void ResetPooledBoid(int32 Index, const FVector& Position);
+
+	// Activates or returns to the pool the boids between the current and the new active count
+	void SetNumActiveBoids(int32 NumActive);
+
+	// Transform of one instance, pooled boids collapse to a zero scale
+	FTransform GetInstanceTransform(int32 Index) const;
+
+	// Follows the actors of the sources and hands the sources to the simulation
+	void UpdateInfluences();
+
+	// Traces the obstacle avoidance rays of every boid for the next batch step
+	void GatherObstacleAvoidance();
+
+	// Reads the results of the asynchronous rays issued on the previous frame
+	void ConsumeObstacleTraces();
+
+	// Issues the asynchronous rays of every boid from the current flock state
+	void IssueObstacleTraces();
+
+	// Gathers the synchronous avoidance input and runs one simulation step, asynchronous rays are read once per frame before the steps
+	void StepSimulation(float DeltaTime, double& AvoidanceSeconds);
+
+	// Position and velocity of one boid to render, interpolated between the last two steps
+	void GetRenderState(int32 Index, FVector& OutPosition, FVector& OutVelocity) const;
+
+	// Writes the simulated positions and headings back to the boid actors
+	void WriteBackTransforms();
+
+	// Adds one instance per boid using the mesh of the boid class
+	void InitializeInstances();
+
+	// Pushes the changed range of instance transforms and the flock bounds, with the animation cycle of every active instance advanced over DeltaTime
+	void WriteBackInstances(float DeltaTime);
+
+	// Whether the flock follows keyframes from the server
+	bool IsFlockReplicationClient() const;
+
+	// Whether the flock is sent to clients
+	bool IsFlockReplicationServer() const;
+
+	// Encodes the current flock into m_Keyframe every m_KeyframeInterval seconds on a replicating server
+	void UpdateKeyframe(float DeltaTime);
+
+	// Encodes the next slice of the current flock into m_Keyframe for the clients
+	void WriteKeyframe();
+
+	// Called on clients when a new keyframe arrives
+	UFUNCTION()
+	void OnRep_Keyframe();
+
+	// Resets the boids of the m_Keyframe slice, steps them up to the local step, and starts blending out their correction
+	void ApplyKeyframe();
+
+	// Steps the boids whose tier is not asleep NumSteps times from FirstStepIndex without avoidance rays, only a baked field is avoided
+	// The shared step index is left where it was
+	void StepWithoutAvoidance(int32 NumSteps, float StepTime, uint32 FirstStepIndex);
+
+	// Creates one Mass entity per pooled boid from the flock state and the processors stepping them
+	void InitializeMassFlock();
+
+	// Runs the flock processors for one step with the avoidance input of the batch rays, the stepped boids are mirrored into the flock state
+	void StepMassFlock(float DeltaTime, TConstArrayView<FBoidsAvoidance> Avoidance);
+
+	// Copies the flock state of the boid at Index to its Mass entity
+	void WriteMassBoid(int32 Index);
+
+	// Entity manager of the world
+	FMassEntityManager& GetMassEntityManager() const;
+
+	// Full path of the replay file
+	FString GetReplayPath() const;
+
+	// Full path of the snapshot file
+	FString GetSnapshotPath() const;
+
+	// Flock state and spatial grid shared by every boid, rebuilt once per frame
+	FBoidsFlockSimulation m_Simulation;
+
+	// Recording in progress when m_ReplayMode is Record
+	FBoidsReplayWriter m_ReplayWriter;
+
+	// Loaded replay when m_ReplayMode is Playback
+	FBoidsReplayReader m_ReplayReader;
+
+	// Simulated time since BeginPlay, or playback time
+	float m_ReplayTime = 0.0f;
+
+	// Spawn positions and headings, seeded from m_Seed so runtime spawns replay the same way
+	FRandomStream m_SpawnRandom;
+
+	// Spawn state being drawn on a worker when spawning is time-sliced
+	TFuture<FBoidsSpawnState> m_SpawnTask;
+
+	// Snapshot opened at BeginPlay, kept until the flock is initialized
+	FBoidsSnapshot m_Snapshot;
+
+	// Whether boids block anything, otherwise spawning skips the collision adjustment
+	bool m_bAdjustSpawnLocation = false;
+
+	// Time spent in each phase of the last tick
+	FBoidsFrameTimings m_LastFrameTimings;
+
+	// Frame time not yet consumed by a fixed step
+	float m_TimeAccumulator = 0.0f;
+
+	// Blend between the previous and current step used for rendering, one without a fixed timestep
+	float m_InterpolationAlpha = 1.0f;
+
+	// Obstacle avoidance input of each boid for the batch step, kept between two reads of the asynchronous rays
+	TArray<FBoidsAvoidance> m_Avoidance;
+
+	// Asynchronous rays in flight, FBoidsAvoidance::NumRays per boid
+	TArray<FTraceHandle> m_PendingTraces;
+
+	// Instance transforms last pushed to the instanced mesh
+	TArray<FTransform> m_InstanceTransforms;
+
+	// Instances that may still be visible, pooled ones beyond it are already collapsed
+	int32 m_NumVisibleInstances = 0;
+
+	// Changed range of instance transforms sent in one batched update
+	TArray<FTransform> m_DirtyInstanceTransforms;
+
+	// Scale applied to every instance, taken from the boid mesh
+	FVector m_InstanceScale = FVector::OneVector;
+
+	// Animation cycle phase of each instance, in [0, 1)
+	TArray<float> m_AnimationPhases;
+
+	// Last flock keyframe taken by the server
+	UPROPERTY(ReplicatedUsing = OnRep_Keyframe)
+	FBoidsFlockKeyframe m_Keyframe;
+
+	// First boid of the next slice sent by the server
+	int32 m_KeyframeCursor = 0;
+
+	// Seconds since the last keyframe was taken
+	float m_KeyframeTimer = 0.0f;
+
+	// Registered attractors and repulsors
+	TArray<FBoidsInfluenceSource> m_InfluenceSources;
+
+	// Handle of the next registered source
+	int32 m_NextInfluenceId = 1;
+
+	// Sources handed to the simulation, reused between frames
+	TArray<FBoidsInfluence> m_Influences;
+
+	// Whether every cluster sleeps, the whole flock frozen
+	bool m_bAsleep = false;
+
+	// Sleep state of each cell holding active boids, asleep boids never leave their cell
+	TMap<FIntVector, FBoidsSleepCluster> m_SleepClusters;
+
+	// Sleep cell of each active boid this frame
+	TArray<FIntVector> m_BoidSleepCells;
+
+	// Whether a keyframe arrived before the flock was initialized
+	bool m_bKeyframePending = false;
+
+	// Offset from the corrected to the previously rendered position of each boid, blended out after a keyframe
+	TArray<FVector> m_Corrections;
+
+	// Weight of m_Corrections, from one when a keyframe is applied down to zero
+	float m_CorrectionAlpha = 0.0f;
+
+	// Mass entity of each pooled boid when m_Backend is MassEntity
+	TArray<FMassEntityHandle> m_MassEntities;
+
+	// Neighbor, avoidance and steering processors, run in this order
+	UPROPERTY()
+	FMassRuntimePipeline m_MassPipeline;
+
+	// Step context shared by the flock processors
+	FBoidsMassFlock m_MassFlock;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BoidsFlockTypes.h"
+#include "BoidsSteeringKernel.h"
+#include "MassEntityTypes.h"
+#include "BoidsMassFragments.generated.h"
+
+/**
+ * World position of one Mass boid.
+ */
+USTRUCT()
+struct FBoidsMassPositionFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector Value = FVector::ZeroVector;
+};
+
+/**
+ * Velocity of one Mass boid.
+ */
+USTRUCT()
+struct FBoidsMassVelocityFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector Value = FVector::ZeroVector;
+};
+
+/**
+ * Slot of one Mass boid in the flock state, keys its random stream and decides whether it is pooled.
+ */
+USTRUCT()
+struct FBoidsMassIndexFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 Index = INDEX_NONE;
+};
+
+/**
+ * Neighbor sums of one Mass boid, written by the neighbor processor and read by the steering one.
+ */
+USTRUCT()
+struct FBoidsMassSteeringFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	FBoidsSteeringSums Sums;
+};
+
+/**
+ * Obstacle avoidance input of one Mass boid for the next step.
+ */
+USTRUCT()
+struct FBoidsMassAvoidanceFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	FBoidsAvoidance Value;
+};
+
+/**
+ * Steering parameters shared by every boid of one flock.
+ * Only the flock id is a property, so each manager gets its own chunks
+ * and its processors filter them on it.
+ */
+USTRUCT()
+struct FBoidsMassParamsFragment : public FMassConstSharedFragment
+{
+	GENERATED_BODY()
+
+	// Id of the manager owning the flock
+	UPROPERTY()
+	uint32 FlockId = 0;
+
+	// Steering parameters of the flock
+	FBoidsSettings Settings;
+};
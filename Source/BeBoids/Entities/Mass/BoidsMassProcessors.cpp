@@ -0,0 +1,189 @@
+#include "BoidsMassProcessors.h"
+#include "BoidsMassFragments.h"
+#include "BoidsFlockSimulation.h"
+#include "BoidsRandom.h"
+#include "BoidsRules.h"
+#include "BoidsStats.h"
+#include "MassExecutionContext.h"
+
+UBoidsMassProcessor::UBoidsMassProcessor()
+	: m_EntityQuery(*this)
+{
+	// The owning manager runs the processors of its flock, they never join the Mass phases
+	bAutoRegisterWithProcessingPhases = false;
+	ExecutionFlags = int32(EProcessorExecutionFlags::All);
+}
+
+void UBoidsMassProcessor::FilterFlockChunks()
+{
+	m_EntityQuery.AddConstSharedRequirement<FBoidsMassParamsFragment>();
+	m_EntityQuery.SetChunkFilter([this](const FMassExecutionContext& Context)
+	{
+		return m_Flock && Context.GetConstSharedFragment<FBoidsMassParamsFragment>().FlockId == m_Flock->FlockId;
+	});
+}
+
+void UBoidsMassNeighborProcessor::ConfigureQueries()
+{
+	m_EntityQuery.AddRequirement<FBoidsMassPositionFragment>(EMassFragmentAccess::ReadOnly);
+	m_EntityQuery.AddRequirement<FBoidsMassVelocityFragment>(EMassFragmentAccess::ReadOnly);
+	m_EntityQuery.AddRequirement<FBoidsMassIndexFragment>(EMassFragmentAccess::ReadOnly);
+	m_EntityQuery.AddRequirement<FBoidsMassSteeringFragment>(EMassFragmentAccess::ReadWrite);
+	FilterFlockChunks();
+}
+
+void UBoidsMassNeighborProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	BOIDS_SCOPE_CYCLE_COUNTER(STAT_BoidsFindNeighbors);
+
+	FBoidsMassFlock& Flock = *m_Flock;
+	const int32 NumActive = Flock.NumActive;
+
+	// The grid needs the boids indexed like the flock state, the fragments are gathered into it first
+	Flock.Positions.SetNumUninitialized(Flock.State->Num(), EAllowShrinking::No);
+	Flock.Velocities.SetNumUninitialized(Flock.State->Num(), EAllowShrinking::No);
+
+	FBoidsSettings Settings;
+	m_EntityQuery.ForEachEntityChunk(EntityManager, Context, [&Flock, &Settings](FMassExecutionContext& ChunkContext)
+	{
+		Settings = ChunkContext.GetConstSharedFragment<FBoidsMassParamsFragment>().Settings;
+
+		const TConstArrayView<FBoidsMassPositionFragment> Positions = ChunkContext.GetFragmentView<FBoidsMassPositionFragment>();
+		const TConstArrayView<FBoidsMassVelocityFragment> Velocities = ChunkContext.GetFragmentView<FBoidsMassVelocityFragment>();
+		const TConstArrayView<FBoidsMassIndexFragment> Indices = ChunkContext.GetFragmentView<FBoidsMassIndexFragment>();
+
+		for (int32 i = 0; i < ChunkContext.GetNumEntities(); i++)
+		{
+			Flock.Positions[Indices[i].Index] = Positions[i].Value;
+			Flock.Velocities[Indices[i].Index] = Velocities[i].Value;
+		}
+	});
+
+	Flock.Grid.Build(MakeArrayView(Flock.Positions.GetData(), NumActive), FBoidsFlockSimulation::GetGridCellSize(Settings));
+	if (FBoidsFlockSimulation::UsesFarField(Settings))
+	{
+		Flock.Grid.BuildAggregates(MakeArrayView(Flock.Velocities.GetData(), NumActive), Settings.PerceptionRadius);
+	}
+	Flock.Influences.Evaluate(Flock.Grid, NumActive);
+
+	// Every boid reads the gathered arrays only, so chunks are independent
+	m_EntityQuery.ParallelForEachEntityChunk(EntityManager, Context, [&Flock, &Settings](FMassExecutionContext& ChunkContext)
+	{
+		const TConstArrayView<FBoidsMassIndexFragment> Indices = ChunkContext.GetFragmentView<FBoidsMassIndexFragment>();
+		const TArrayView<FBoidsMassSteeringFragment> Steering = ChunkContext.GetMutableFragmentView<FBoidsMassSteeringFragment>();
+
+		FBoidsNeighborBuffer Neighbors;
+		for (int32 i = 0; i < ChunkContext.GetNumEntities(); i++)
+		{
+			const int32 Index = Indices[i].Index;
+			if (!Flock.IsSimulated(Index))
+			{
+				continue;
+			}
+
+			Neighbors.Reset();
+			FBoidsFlockSimulation::GatherGridNeighbors(Flock.Grid, Settings, Index, Flock.Positions, Flock.Velocities, Neighbors);
+			Steering[i].Sums = FBoidsRules::GatherSums(Neighbors, Settings);
+			Steering[i].Sums.Influence = Flock.Influences.GetForce(Index);
+		}
+	});
+}
+
+void UBoidsMassAvoidanceProcessor::ConfigureQueries()
+{
+	m_EntityQuery.AddRequirement<FBoidsMassPositionFragment>(EMassFragmentAccess::ReadOnly);
+	m_EntityQuery.AddRequirement<FBoidsMassIndexFragment>(EMassFragmentAccess::ReadOnly);
+	m_EntityQuery.AddRequirement<FBoidsMassAvoidanceFragment>(EMassFragmentAccess::ReadWrite);
+	FilterFlockChunks();
+}
+
+void UBoidsMassAvoidanceProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	BOIDS_SCOPE_CYCLE_COUNTER(STAT_BoidsObstacleAvoidance);
+
+	const FBoidsMassFlock& Flock = *m_Flock;
+
+	// No scene query is made here, every boid reads the field or its own entry of the manager rays
+	m_EntityQuery.ParallelForEachEntityChunk(EntityManager, Context, [&Flock](FMassExecutionContext& ChunkContext)
+	{
+		const float AvoidanceWeight = ChunkContext.GetConstSharedFragment<FBoidsMassParamsFragment>().Settings.AvoidanceWeight;
+		const TConstArrayView<FBoidsMassPositionFragment> Positions = ChunkContext.GetFragmentView<FBoidsMassPositionFragment>();
+		const TConstArrayView<FBoidsMassIndexFragment> Indices = ChunkContext.GetFragmentView<FBoidsMassIndexFragment>();
+		const TArrayView<FBoidsMassAvoidanceFragment> Avoidances = ChunkContext.GetMutableFragmentView<FBoidsMassAvoidanceFragment>();
+
+		for (int32 i = 0; i < ChunkContext.GetNumEntities(); i++)
+		{
+			FBoidsAvoidance& Avoidance = Avoidances[i].Value;
+			Avoidance = FBoidsAvoidance();
+
+			const int32 Index = Indices[i].Index;
+			if (!Flock.IsSimulated(Index))
+			{
+				continue;
+			}
+
+			// A baked field replaces the scene queries with one trilinear lookup
+			if (Flock.DistanceField)
+			{
+				float ObstacleDistance = 0.0f;
+				FVector ObstacleGradient = FVector::ZeroVector;
+				if (Flock.DistanceField->Sample(Positions[i].Value, ObstacleDistance, ObstacleGradient))
+				{
+					Avoidance.AddFieldSample(ObstacleDistance, ObstacleGradient, AvoidanceWeight);
+				}
+				Avoidance.Finalize();
+				continue;
+			}
+
+			if (Flock.Avoidance.IsValidIndex(Index))
+			{
+				Avoidance = Flock.Avoidance[Index];
+			}
+		}
+	});
+}
+
+void UBoidsMassSteeringProcessor::ConfigureQueries()
+{
+	m_EntityQuery.AddRequirement<FBoidsMassPositionFragment>(EMassFragmentAccess::ReadWrite);
+	m_EntityQuery.AddRequirement<FBoidsMassVelocityFragment>(EMassFragmentAccess::ReadWrite);
+	m_EntityQuery.AddRequirement<FBoidsMassIndexFragment>(EMassFragmentAccess::ReadOnly);
+	m_EntityQuery.AddRequirement<FBoidsMassSteeringFragment>(EMassFragmentAccess::ReadOnly);
+	m_EntityQuery.AddRequirement<FBoidsMassAvoidanceFragment>(EMassFragmentAccess::ReadOnly);
+	FilterFlockChunks();
+}
+
+void UBoidsMassSteeringProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	BOIDS_SCOPE_CYCLE_COUNTER(STAT_BoidsSteering);
+
+	const FBoidsMassFlock& Flock = *m_Flock;
+
+	m_EntityQuery.ParallelForEachEntityChunk(EntityManager, Context, [&Flock](FMassExecutionContext& ChunkContext)
+	{
+		const FBoidsSettings& Settings = ChunkContext.GetConstSharedFragment<FBoidsMassParamsFragment>().Settings;
+		const float DeltaTime = ChunkContext.GetDeltaTimeSeconds();
+		const TArrayView<FBoidsMassPositionFragment> Positions = ChunkContext.GetMutableFragmentView<FBoidsMassPositionFragment>();
+		const TArrayView<FBoidsMassVelocityFragment> Velocities = ChunkContext.GetMutableFragmentView<FBoidsMassVelocityFragment>();
+		const TConstArrayView<FBoidsMassIndexFragment> Indices = ChunkContext.GetFragmentView<FBoidsMassIndexFragment>();
+		const TConstArrayView<FBoidsMassSteeringFragment> Steering = ChunkContext.GetFragmentView<FBoidsMassSteeringFragment>();
+		const TConstArrayView<FBoidsMassAvoidanceFragment> Avoidances = ChunkContext.GetFragmentView<FBoidsMassAvoidanceFragment>();
+
+		for (int32 i = 0; i < ChunkContext.GetNumEntities(); i++)
+		{
+			const int32 Index = Indices[i].Index;
+			if (!Flock.IsSimulated(Index))
+			{
+				continue;
+			}
+
+			// Same stream as the batch simulation, a seed steps the same flock with either backend
+			FBoidsRandom Random(Flock.Seed, Index, Flock.StepIndex);
+			FBoidsRules::Integrate(Settings, Steering[i].Sums, Avoidances[i].Value, Random, DeltaTime, Positions[i].Value, Velocities[i].Value);
+
+			// Every boid owns its slot, the state is written from any worker
+			Flock.State->Positions[Index] = Positions[i].Value;
+			Flock.State->Velocities[Index] = Velocities[i].Value;
+		}
+	});
+}
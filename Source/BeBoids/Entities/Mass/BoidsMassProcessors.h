@@ -0,0 +1,127 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BoidsDistanceField.h"
+#include "BoidsFlockTypes.h"
+#include "BoidsInfluence.h"
+#include "BoidsSpatialGrid.h"
+#include "MassEntityQuery.h"
+#include "MassProcessor.h"
+#include "BoidsMassProcessors.generated.h"
+
+/**
+ * FBoidsMassFlock is the per step context shared by the processors of one flock.
+ * It is owned by the manager, which fills it before running the processors.
+ */
+struct FBoidsMassFlock
+{
+	// Id of the manager owning the flock, matches FBoidsMassParamsFragment::FlockId
+	uint32 FlockId = 0;
+
+	// Number of simulated boids, entities with a higher index are pooled
+	int32 NumActive = 0;
+
+	// Seed of the per boid random streams
+	uint32 Seed = 0;
+
+	// Index of the step being run, keys the random streams
+	uint32 StepIndex = 0;
+
+	// Baked obstacle field, replaces the avoidance traces when set, not owned
+	const FBoidsDistanceField* DistanceField = nullptr;
+
+	// Avoidance input read from the manager rays, indexed like the flock state, empty to avoid nothing
+	TConstArrayView<FBoidsAvoidance> Avoidance;
+
+	// Simulation tier of each boid, indexed like the flock state, asleep boids are left untouched
+	TConstArrayView<EBoidsLod> Lods;
+
+	// Positions and velocities at the start of the step, indexed like the flock state
+	TArray<FVector> Positions;
+	TArray<FVector> Velocities;
+
+	// Spatial grid built from Positions
+	FBoidsSpatialGrid Grid;
+
+	// Attractors and repulsors, evaluated through Grid
+	FBoidsInfluenceField Influences;
+
+	// Flock state receiving the stepped boids for rendering and recording, not owned
+	FBoidsFlockState* State = nullptr;
+
+	// Whether the boid at Index is stepped, neither pooled nor asleep
+	bool IsSimulated(int32 Index) const
+	{
+		return Index < NumActive && !(Lods.IsValidIndex(Index) && Lods[Index] == EBoidsLod::Asleep);
+	}
+};
+
+/**
+ * UBoidsMassProcessor is the base of the flock processors.
+ * They are run by the manager owning the flock rather than by the Mass
+ * processing phases, and only visit the chunks of that flock.
+ */
+UCLASS(Abstract)
+class BEBOIDS_API UBoidsMassProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	// Constructor
+	UBoidsMassProcessor();
+
+	// Flock the processor steps, must outlive it
+	void SetFlock(FBoidsMassFlock* Flock) { m_Flock = Flock; }
+
+protected:
+	// Restricts the query to the chunks of the flock
+	void FilterFlockChunks();
+
+	// Flock being stepped
+	FBoidsMassFlock* m_Flock = nullptr;
+
+	// Boids of the flock
+	FMassEntityQuery m_EntityQuery;
+};
+
+/**
+ * UBoidsMassNeighborProcessor builds the spatial grid from the boid fragments,
+ * then gathers the neighbor sums of every boid in parallel.
+ */
+UCLASS()
+class BEBOIDS_API UBoidsMassNeighborProcessor : public UBoidsMassProcessor
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+};
+
+/**
+ * UBoidsMassAvoidanceProcessor fills the avoidance input of every boid in parallel,
+ * from the distance field when there is one, otherwise from the rays batched by the manager.
+ */
+UCLASS()
+class BEBOIDS_API UBoidsMassAvoidanceProcessor : public UBoidsMassProcessor
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+};
+
+/**
+ * UBoidsMassSteeringProcessor applies the rules to every boid in parallel
+ * and integrates it, the same way FBoidsFlockSimulation steps a near boid.
+ */
+UCLASS()
+class BEBOIDS_API UBoidsMassSteeringProcessor : public UBoidsMassProcessor
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+};
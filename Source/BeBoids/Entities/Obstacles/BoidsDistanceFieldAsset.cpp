@@ -0,0 +1,79 @@
+#include "BoidsDistanceFieldAsset.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/OverlapResult.h"
+#include "Engine/World.h"
+
+void UBoidsDistanceFieldAsset::Bake(UWorld* World, const FBox& Bounds, float VoxelSize, float MaxDistance)
+{
+	if (!World || !Bounds.IsValid || VoxelSize <= 0.0f)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Invalid distance field bake parameters."));
+		return;
+	}
+
+	const FVector Size = Bounds.GetSize();
+	const FIntVector Resolution(
+		FMath::Max(2, FMath::CeilToInt32(Size.X / VoxelSize) + 1),
+		FMath::Max(2, FMath::CeilToInt32(Size.Y / VoxelSize) + 1),
+		FMath::Max(2, FMath::CeilToInt32(Size.Z / VoxelSize) + 1)
+	);
+
+	m_Field.Initialize(Bounds.Min, VoxelSize, Resolution, MaxDistance);
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(BoidsDistanceFieldBake), false);
+	const FCollisionObjectQueryParams ObjectParams(ECC_WorldStatic);
+	const FCollisionShape Probe = FCollisionShape::MakeSphere(MaxDistance);
+
+	TArray<FOverlapResult> Overlaps;
+
+	for (int32 Z = 0; Z < Resolution.Z; Z++)
+	{
+		for (int32 Y = 0; Y < Resolution.Y; Y++)
+		{
+			for (int32 X = 0; X < Resolution.X; X++)
+			{
+				const FVector Node = Bounds.Min + FVector(X, Y, Z) * VoxelSize;
+				float Distance = MaxDistance;
+
+				Overlaps.Reset();
+				World->OverlapMultiByObjectType(Overlaps, Node, FQuat::Identity, ObjectParams, Probe, QueryParams);
+
+				for (const FOverlapResult& Overlap : Overlaps)
+				{
+					const UPrimitiveComponent* Component = Overlap.GetComponent();
+					if (!Component || Component->Mobility != EComponentMobility::Static)
+					{
+						continue;
+					}
+
+					FVector ClosestPoint;
+					const float ComponentDistance = Component->GetDistanceToCollision(Node, ClosestPoint);
+
+					// Zero means the node lies inside the collision
+					if (ComponentDistance == 0.0f)
+					{
+						Distance = -VoxelSize;
+					}
+					else if (ComponentDistance > 0.0f)
+					{
+						Distance = FMath::Min(Distance, ComponentDistance);
+					}
+				}
+
+				m_Field.Distances[m_Field.GetIndex(X, Y, Z)] = Distance;
+			}
+		}
+	}
+
+	m_Field.ComputeGradients();
+	MarkPackageDirty();
+
+	UE_LOG(LogTemp, Log, TEXT("Baked boids distance field %s (%d x %d x %d nodes)."), *GetName(), Resolution.X, Resolution.Y, Resolution.Z);
+}
+
+void UBoidsDistanceFieldAsset::Serialize(FArchive& Ar)
+{
+	Super::Serialize(Ar);
+
+	Ar << m_Field;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "BoidsDistanceField.h"
+#include "BoidsDistanceFieldAsset.generated.h"
+
+/**
+ * UBoidsDistanceFieldAsset stores a distance field baked from the static
+ * collision of a level, used by the batch simulation instead of raycasts.
+ */
+UCLASS(BlueprintType)
+class BEBOIDS_API UBoidsDistanceFieldAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	// Samples the static collision of World inside Bounds, one node every VoxelSize
+	void Bake(UWorld* World, const FBox& Bounds, float VoxelSize, float MaxDistance);
+
+	// Baked field
+	const FBoidsDistanceField& GetField() const { return m_Field; }
+
+	// Serializes the baked field along with the asset
+	virtual void Serialize(FArchive& Ar) override;
+
+private:
+	// Baked field
+	FBoidsDistanceField m_Field;
+};
@@ -1,19 +1,19 @@
-// Copyright Epic Games, Inc. All Rights Reserved.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "GameFramework/GameModeBase.h"
-#include "BeBoidsGameMode.generated.h"
-
-UCLASS(minimalapi)
-class ABeBoidsGameMode : public AGameModeBase
-{
-	GENERATED_BODY()
-
-public:
-	ABeBoidsGameMode();
-};
-
-
-
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameModeBase.h"
+#include "BeBoidsGameMode.generated.h"
+
+UCLASS(minimalapi)
+class ABeBoidsGameMode : public AGameModeBase
+{
+	GENERATED_BODY()
+
+public:
+	ABeBoidsGameMode();
+};
+
+
+
@@ -0,0 +1,23 @@
+using UnrealBuildTool;
+using System.Collections.Generic;
+
+// Headless program stepping the BoidsCore flock, needs an engine built from source
+[SupportedPlatforms(UnrealPlatformClass.Desktop)]
+public class BoidsBenchmarkTarget : TargetRules
+{
+	public BoidsBenchmarkTarget(TargetInfo Target) : base(Target)
+	{
+		Type = TargetType.Program;
+		LinkType = TargetLinkType.Monolithic;
+		LaunchModuleName = "BoidsBenchmark";
+		DefaultBuildSettings = BuildSettingsVersion.V5;
+		IncludeOrderVersion = EngineIncludeOrderVersion.Unreal5_4;
+
+		bBuildDeveloperTools = false;
+		bCompileAgainstEngine = false;
+		bCompileAgainstCoreUObject = false;
+		bCompileAgainstApplicationCore = false;
+		bCompileICU = false;
+		bIsBuildingConsoleApplication = true;
+	}
+}
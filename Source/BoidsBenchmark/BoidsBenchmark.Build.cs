@@ -0,0 +1,12 @@
+using UnrealBuildTool;
+
+public class BoidsBenchmark : ModuleRules
+{
+	public BoidsBenchmark(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PublicIncludePaths.Add("Runtime/Launch/Public");
+		PrivateIncludePaths.Add("Runtime/Launch/Private");
+
+		PrivateDependencyModuleNames.AddRange(new string[] { "Core", "Projects", "BoidsCore" });
+	}
+}
@@ -0,0 +1,86 @@
+#include "BoidsFlockSimulation.h"
+#include "RequiredProgramMainCPPInclude.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogBoidsBenchmark, Log, All);
+
+IMPLEMENT_APPLICATION(BoidsBenchmark, "BoidsBenchmark");
+
+/**
+ * Steps N boids for K frames without any engine or world and reports
+ * the cost per boid and per step.
+ *
+ * Usage: BoidsBenchmark -boids=10000 -frames=300 -extent=5000 -parallel=false -seed=0
+ */
+INT32_MAIN_INT32_ARGC_TCHAR_ARGV()
+{
+	FTaskTagScope Scope(ETaskTag::EGameThread);
+	ON_SCOPE_EXIT
+	{
+		RequestEngineExit(TEXT("Exiting"));
+		FEngineLoop::AppPreExit();
+		FModuleManager::Get().UnloadModulesAtShutdown();
+		FEngineLoop::AppExit();
+	};
+
+	if (int32 Ret = GEngineLoop.PreInit(ArgC, ArgV))
+	{
+		return Ret;
+	}
+
+	int32 NumBoids = 10000;
+	int32 NumFrames = 300;
+	float Extent = 5000.0f;
+	bool bParallel = true;
+	int32 Seed = 0;
+	int32 TopologicalNeighbors = 0;
+	float PerceptionRadius = FBoidsSettings().PerceptionRadius;
+	float FarFieldRadius = 0.0f;
+
+	FParse::Value(FCommandLine::Get(), TEXT("-boids="), NumBoids);
+	FParse::Value(FCommandLine::Get(), TEXT("-frames="), NumFrames);
+	FParse::Value(FCommandLine::Get(), TEXT("-extent="), Extent);
+	FParse::Value(FCommandLine::Get(), TEXT("-seed="), Seed);
+	FParse::Value(FCommandLine::Get(), TEXT("-neighbors="), TopologicalNeighbors);
+	FParse::Value(FCommandLine::Get(), TEXT("-perception="), PerceptionRadius);
+	FParse::Value(FCommandLine::Get(), TEXT("-farfield="), FarFieldRadius);
+	FParse::Bool(FCommandLine::Get(), TEXT("-parallel="), bParallel);
+
+	NumBoids = FMath::Max(NumBoids, 1);
+	NumFrames = FMath::Max(NumFrames, 1);
+
+	// Same spawn as ABoidsManager, inside a box of half size Extent
+	FBoidsSettings Settings;
+	Settings.TopologicalNeighbors = TopologicalNeighbors;
+	Settings.PerceptionRadius = PerceptionRadius;
+	Settings.FarFieldRadius = FarFieldRadius;
+
+	FBoidsFlockSimulation Simulation;
+	Simulation.Initialize(Settings, NumBoids);
+	Simulation.SetParallel(bParallel);
+	Simulation.SetSeed(Seed);
+
+	FRandomStream Random(Seed);
+	FBoidsFlockState& State = Simulation.GetState();
+	for (int32 i = 0; i < NumBoids; i++)
+	{
+		State.Positions[i] = FVector(Random.FRandRange(-Extent, Extent), Random.FRandRange(-Extent, Extent), Random.FRandRange(-Extent, Extent) * 0.4f);
+		State.Velocities[i] = Random.GetUnitVector() * Simulation.GetSettings().MinSpeed;
+	}
+
+	const float DeltaTime = 1.0f / 60.0f;
+	const double StartTime = FPlatformTime::Seconds();
+
+	for (int32 Frame = 0; Frame < NumFrames; Frame++)
+	{
+		Simulation.Step(DeltaTime, TConstArrayView<FBoidsAvoidance>());
+	}
+
+	const double ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+	const double NanosecondsPerBoidStep = ElapsedSeconds * 1.0e9 / (double(NumBoids) * NumFrames);
+
+	UE_LOG(LogBoidsBenchmark, Display, TEXT("%d boids, %d frames, %s: %.3f ms per step, %.1f ns per boid per step"),
+		NumBoids, NumFrames, bParallel ? TEXT("parallel") : TEXT("single thread"),
+		ElapsedSeconds * 1000.0 / NumFrames, NanosecondsPerBoidStep);
+
+	return 0;
+}
@@ -0,0 +1,12 @@
+using UnrealBuildTool;
+
+public class BoidsCore : ModuleRules
+{
+	public BoidsCore(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		// Flocking math only, no UObject or engine dependency so it also builds into standalone programs
+		PublicDependencyModuleNames.AddRange(new string[] { "Core" });
+	}
+}
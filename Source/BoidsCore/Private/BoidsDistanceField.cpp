@@ -0,0 +1,89 @@
+#include "BoidsDistanceField.h"
+
+bool FBoidsDistanceField::IsValid() const
+{
+	const int32 NumNodes = Resolution.X * Resolution.Y * Resolution.Z;
+	return Resolution.GetMin() >= 2 && VoxelSize > 0.0f && Distances.Num() == NumNodes && Gradients.Num() == NumNodes;
+}
+
+void FBoidsDistanceField::Initialize(const FVector& InOrigin, float InVoxelSize, const FIntVector& InResolution, float MaxDistance)
+{
+	Origin = InOrigin;
+	VoxelSize = InVoxelSize;
+	Resolution = InResolution;
+
+	const int32 NumNodes = Resolution.X * Resolution.Y * Resolution.Z;
+	Distances.Init(MaxDistance, NumNodes);
+	Gradients.Init(FVector3f::ZeroVector, NumNodes);
+}
+
+void FBoidsDistanceField::ComputeGradients()
+{
+	for (int32 Z = 0; Z < Resolution.Z; Z++)
+	{
+		for (int32 Y = 0; Y < Resolution.Y; Y++)
+		{
+			for (int32 X = 0; X < Resolution.X; X++)
+			{
+				// One sided differences on the borders of the grid
+				const FVector3f Gradient(
+					Distances[GetIndex(FMath::Min(X + 1, Resolution.X - 1), Y, Z)] - Distances[GetIndex(FMath::Max(X - 1, 0), Y, Z)],
+					Distances[GetIndex(X, FMath::Min(Y + 1, Resolution.Y - 1), Z)] - Distances[GetIndex(X, FMath::Max(Y - 1, 0), Z)],
+					Distances[GetIndex(X, Y, FMath::Min(Z + 1, Resolution.Z - 1))] - Distances[GetIndex(X, Y, FMath::Max(Z - 1, 0))]
+				);
+
+				Gradients[GetIndex(X, Y, Z)] = Gradient.GetSafeNormal();
+			}
+		}
+	}
+}
+
+bool FBoidsDistanceField::Sample(const FVector& Position, float& OutDistance, FVector& OutGradient) const
+{
+	const FVector Local = (Position - Origin) / VoxelSize;
+
+	if (Local.X < 0.0 || Local.Y < 0.0 || Local.Z < 0.0 ||
+		Local.X > Resolution.X - 1 || Local.Y > Resolution.Y - 1 || Local.Z > Resolution.Z - 1)
+	{
+		return false;
+	}
+
+	// Lower corner of the cell, clamped so the upper corner stays in the grid
+	const int32 X = FMath::Min(FMath::FloorToInt32(Local.X), Resolution.X - 2);
+	const int32 Y = FMath::Min(FMath::FloorToInt32(Local.Y), Resolution.Y - 2);
+	const int32 Z = FMath::Min(FMath::FloorToInt32(Local.Z), Resolution.Z - 2);
+
+	const float FX = Local.X - X;
+	const float FY = Local.Y - Y;
+	const float FZ = Local.Z - Z;
+
+	float Distance = 0.0f;
+	FVector3f Gradient = FVector3f::ZeroVector;
+
+	for (int32 Corner = 0; Corner < 8; Corner++)
+	{
+		const int32 CX = Corner & 1;
+		const int32 CY = (Corner >> 1) & 1;
+		const int32 CZ = (Corner >> 2) & 1;
+
+		const float Weight = (CX ? FX : 1.0f - FX) * (CY ? FY : 1.0f - FY) * (CZ ? FZ : 1.0f - FZ);
+		const int32 Index = GetIndex(X + CX, Y + CY, Z + CZ);
+
+		Distance += Distances[Index] * Weight;
+		Gradient += Gradients[Index] * Weight;
+	}
+
+	OutDistance = Distance;
+	OutGradient = FVector(Gradient.GetSafeNormal());
+	return true;
+}
+
+FArchive& operator<<(FArchive& Ar, FBoidsDistanceField& Field)
+{
+	Ar << Field.Origin;
+	Ar << Field.VoxelSize;
+	Ar << Field.Resolution;
+	Ar << Field.Distances;
+	Ar << Field.Gradients;
+	return Ar;
+}
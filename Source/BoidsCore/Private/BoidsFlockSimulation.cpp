@@ -0,0 +1,387 @@
+#include "BoidsFlockSimulation.h"
+#include "BoidsRules.h"
+#include "BoidsStats.h"
+#include "Async/ParallelFor.h"
+
+namespace
+{
+	// Number of boids stepped by one parallel task
+	constexpr int32 ChunkSize = 256;
+}
+
+TRACE_DECLARE_INT_COUNTER(BoidsNumCounter, TEXT("Boids/Boids"));
+TRACE_DECLARE_FLOAT_COUNTER(BoidsAverageNeighborsCounter, TEXT("Boids/Average Neighbors"));
+TRACE_DECLARE_INT_COUNTER(BoidsMaxNeighborsCounter, TEXT("Boids/Max Neighbors"));
+
+void FBoidsFlockSimulation::Initialize(const FBoidsSettings& Settings, int32 NumBoids)
+{
+	m_Settings = Settings;
+	m_States[0].SetNum(NumBoids);
+	m_States[1].SetNum(NumBoids);
+	m_CurrentState = 0;
+	m_Lods.Init(EBoidsLod::Near, NumBoids);
+	m_Pending.Init(false, NumBoids);
+	m_NumActive = NumBoids;
+	m_ChunkCursor = 0;
+	m_StepIndex = 0;
+	m_Grid.Reset();
+}
+
+void FBoidsFlockSimulation::CopyStateToPrevious()
+{
+	m_States[1 - m_CurrentState] = m_States[m_CurrentState];
+}
+
+void FBoidsFlockSimulation::SetNumActive(int32 NumActive)
+{
+	m_NumActive = FMath::Clamp(NumActive, 0, GetState().Num());
+}
+
+void FBoidsFlockSimulation::ResetBoid(int32 Index, const FVector& Position, const FVector& Velocity)
+{
+	for (FBoidsFlockState& State : m_States)
+	{
+		if (State.Positions.IsValidIndex(Index))
+		{
+			State.Positions[Index] = Position;
+			State.Velocities[Index] = Velocity;
+		}
+	}
+
+	if (m_Lods.IsValidIndex(Index))
+	{
+		m_Lods[Index] = EBoidsLod::Near;
+		m_Pending[Index] = false;
+	}
+}
+
+void FBoidsFlockSimulation::RebuildGrid()
+{
+	BOIDS_SCOPE_CYCLE_COUNTER(STAT_BoidsGridBuild);
+
+	// With a far field the cells shrink to its radius, only the cells around a boid are walked point by point
+	m_Grid.Build(MakeArrayView(GetState().Positions.GetData(), m_NumActive), GetGridCellSize(m_Settings));
+}
+
+bool FBoidsFlockSimulation::UsesFarField(const FBoidsSettings& Settings)
+{
+	return Settings.FarFieldRadius > 0.0f && Settings.FarFieldRadius < Settings.PerceptionRadius && Settings.TopologicalNeighbors == 0;
+}
+
+float FBoidsFlockSimulation::GetGridCellSize(const FBoidsSettings& Settings)
+{
+	return UsesFarField(Settings) ? Settings.FarFieldRadius : Settings.PerceptionRadius;
+}
+
+void FBoidsFlockSimulation::Step(float DeltaTime, TConstArrayView<FBoidsAvoidance> Avoidance)
+{
+	BOIDS_SCOPE_CYCLE_COUNTER(STAT_BoidsStep);
+
+	const double GridStartTime = FPlatformTime::Seconds();
+	RebuildGrid();
+
+	const FBoidsFlockState& Previous = m_States[m_CurrentState];
+	if (UsesFarField(m_Settings))
+	{
+		m_Grid.BuildAggregates(MakeArrayView(Previous.Velocities.GetData(), m_NumActive), m_Settings.PerceptionRadius);
+	}
+
+	// Sources reach their boids through the grid, so only the affected boids pay for them
+	m_Influences.Evaluate(m_Grid, m_NumActive);
+	const double StepStartTime = FPlatformTime::Seconds();
+
+	FBoidsFlockState& Next = m_States[1 - m_CurrentState];
+	Next.SetNum(Previous.Num());
+
+	const int32 NumChunks = FMath::DivideAndRoundUp(m_NumActive, ChunkSize);
+
+	// Tiers are staggered on the index of this step, read once before the counter moves on
+	const uint32 StepIndex = m_StepIndex;
+
+	// Cycles spent gathering neighbors and applying the rules, per chunk
+	TArray<uint64> GatherCycles;
+	TArray<uint64> RulesCycles;
+	if (m_bPhaseTimings)
+	{
+		GatherCycles.SetNumZeroed(NumChunks);
+		RulesCycles.SetNumZeroed(NumChunks);
+	}
+
+	// Stepped and deferred boids and the neighbor count totals and maximum, per chunk
+	TArray<int32> ChunkStepped;
+	TArray<int32> ChunkDeferred;
+	TArray<int64> ChunkNeighbors;
+	TArray<int32> ChunkMaxNeighbors;
+	ChunkStepped.SetNumZeroed(NumChunks);
+	ChunkDeferred.SetNumZeroed(NumChunks);
+	ChunkNeighbors.SetNumZeroed(NumChunks);
+	ChunkMaxNeighbors.SetNumZeroed(NumChunks);
+
+	// Past the deadline due boids are extrapolated and carried over to the next step
+	const bool bBudgeted = m_StepBudgetSeconds > 0.0;
+	const double RemainingSeconds = FMath::Max(m_StepBudgetSeconds - (StepStartTime - GridStartTime), 0.0);
+	const uint64 Deadline = bBudgeted ? FPlatformTime::Cycles64() + uint64(RemainingSeconds / FPlatformTime::GetSecondsPerCycle64()) : MAX_uint64;
+	const int32 ChunkCursor = NumChunks > 0 ? m_ChunkCursor % NumChunks : 0;
+
+	// With a budget, near and carried over boids get a first pass, the other due boids a second one
+	for (int32 Pass = bBudgeted ? 0 : 1; Pass < 2; Pass++)
+	{
+		ParallelFor(NumChunks, [&](int32 Order)
+		{
+			BOIDS_SCOPE_CYCLE_COUNTER(STAT_BoidsStepChunk);
+
+			// Chunks are handed out from the round-robin cursor, so the same boids are not always the ones deferred
+			const int32 Chunk = (Order + ChunkCursor) % NumChunks;
+
+			FBoidsNeighborBuffer Neighbors;
+			const FBoidsAvoidance NoAvoidance;
+
+			const int32 End = FMath::Min((Chunk + 1) * ChunkSize, m_NumActive);
+			for (int32 i = Chunk * ChunkSize; i < End; i++)
+			{
+				const EBoidsLod Lod = m_Lods.IsValidIndex(i) ? m_Lods[i] : EBoidsLod::Near;
+				const bool bPending = m_Pending.IsValidIndex(i) && m_Pending[i];
+
+				// Asleep boids keep their state as is, on the last pass so they are copied once
+				if (Lod == EBoidsLod::Asleep)
+				{
+					if (Pass == 1)
+					{
+						Next.Positions[i] = Previous.Positions[i];
+						Next.Velocities[i] = Previous.Velocities[i];
+					}
+					continue;
+				}
+
+				// Each boid is handled by exactly one pass
+				const bool bHighPriority = Lod == EBoidsLod::Near || bPending;
+				if (bBudgeted && bHighPriority != (Pass == 0))
+				{
+					continue;
+				}
+
+				// Boids of the reduced tiers keep their velocity between two steps, as do deferred ones
+				const bool bDue = bPending || IsSteppedAt(i, Lod, StepIndex);
+				if (!bDue || (bBudgeted && FPlatformTime::Cycles64() >= Deadline))
+				{
+					Next.Positions[i] = Previous.Positions[i];
+					Next.Velocities[i] = Previous.Velocities[i];
+					FBoidsRules::Extrapolate(m_Settings, DeltaTime, Previous.Velocities[i], Next.Positions[i]);
+
+					if (bDue)
+					{
+						m_Pending[i] = true;
+						ChunkDeferred[Chunk]++;
+					}
+					continue;
+				}
+
+				const FBoidsAvoidance& BoidAvoidance = Avoidance.IsValidIndex(i) ? Avoidance[i] : NoAvoidance;
+
+				if (m_bPhaseTimings)
+				{
+					const uint64 GatherStart = FPlatformTime::Cycles64();
+					GatherNeighbors(i, Lod, Previous, Neighbors);
+					const uint64 RulesStart = FPlatformTime::Cycles64();
+					StepBoid(i, DeltaTime, Lod, BoidAvoidance, Previous, Next, Neighbors);
+
+					GatherCycles[Chunk] += RulesStart - GatherStart;
+					RulesCycles[Chunk] += FPlatformTime::Cycles64() - RulesStart;
+				}
+				else
+				{
+					GatherNeighbors(i, Lod, Previous, Neighbors);
+					StepBoid(i, DeltaTime, Lod, BoidAvoidance, Previous, Next, Neighbors);
+				}
+
+				if (bPending)
+				{
+					m_Pending[i] = false;
+				}
+
+				ChunkStepped[Chunk]++;
+				ChunkNeighbors[Chunk] += Neighbors.Num;
+				ChunkMaxNeighbors[Chunk] = FMath::Max(ChunkMaxNeighbors[Chunk], Neighbors.Num);
+			}
+		}, m_bParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+	}
+
+	// The next step starts from the first chunk that had to defer work
+	for (int32 Order = 0; Order < NumChunks; Order++)
+	{
+		const int32 Chunk = (Order + ChunkCursor) % NumChunks;
+		if (ChunkDeferred[Chunk] > 0)
+		{
+			m_ChunkCursor = Chunk;
+			break;
+		}
+	}
+
+	m_CurrentState = 1 - m_CurrentState;
+	m_StepIndex++;
+
+	// The parallel wall time is shared between the phases in proportion of their cycles
+	const double StepSeconds = FPlatformTime::Seconds() - StepStartTime;
+	double GatherShare = 0.0;
+	if (m_bPhaseTimings)
+	{
+		uint64 TotalGather = 0;
+		uint64 TotalRules = 0;
+		for (int32 Chunk = 0; Chunk < NumChunks; Chunk++)
+		{
+			TotalGather += GatherCycles[Chunk];
+			TotalRules += RulesCycles[Chunk];
+		}
+		GatherShare = TotalGather + TotalRules > 0 ? double(TotalGather) / double(TotalGather + TotalRules) : 0.0;
+	}
+
+	m_LastStepTimings.NeighborSearchSeconds = (StepStartTime - GridStartTime) + StepSeconds * GatherShare;
+	m_LastStepTimings.SteeringSeconds = StepSeconds * (1.0 - GatherShare);
+
+	int32 TotalStepped = 0;
+	int32 TotalDeferred = 0;
+	int64 TotalNeighbors = 0;
+	int32 MaxNeighbors = 0;
+	for (int32 Chunk = 0; Chunk < NumChunks; Chunk++)
+	{
+		TotalStepped += ChunkStepped[Chunk];
+		TotalDeferred += ChunkDeferred[Chunk];
+		TotalNeighbors += ChunkNeighbors[Chunk];
+		MaxNeighbors = FMath::Max(MaxNeighbors, ChunkMaxNeighbors[Chunk]);
+	}
+	const float AverageNeighbors = TotalStepped > 0 ? float(TotalNeighbors) / TotalStepped : 0.0f;
+
+	SET_DWORD_STAT(STAT_BoidsNum, m_NumActive);
+	SET_DWORD_STAT(STAT_BoidsStepped, TotalStepped);
+	SET_DWORD_STAT(STAT_BoidsDeferred, TotalDeferred);
+	SET_QWORD_STAT(STAT_BoidsNeighbors, TotalNeighbors);
+	SET_FLOAT_STAT(STAT_BoidsAverageNeighbors, AverageNeighbors);
+	SET_DWORD_STAT(STAT_BoidsMaxNeighbors, MaxNeighbors);
+
+	TRACE_COUNTER_SET(BoidsNumCounter, m_NumActive);
+	TRACE_COUNTER_SET(BoidsAverageNeighborsCounter, AverageNeighbors);
+	TRACE_COUNTER_SET(BoidsMaxNeighborsCounter, MaxNeighbors);
+}
+
+bool FBoidsFlockSimulation::NeedsAvoidance(int32 Index, uint32 StepIndex) const
+{
+	const EBoidsLod Lod = m_Lods.IsValidIndex(Index) ? m_Lods[Index] : EBoidsLod::Near;
+	const bool bPending = m_Pending.IsValidIndex(Index) && m_Pending[Index];
+	return Lod != EBoidsLod::Far && Lod != EBoidsLod::Asleep && (bPending || IsSteppedAt(Index, Lod, StepIndex));
+}
+
+bool FBoidsFlockSimulation::IsSteppedAt(int32 Index, EBoidsLod Lod, uint32 StepIndex) const
+{
+	// The boid index staggers the reduced tiers so each frame steps the same share of them
+	switch (Lod)
+	{
+	case EBoidsLod::Mid:
+		return (StepIndex + Index) % FMath::Max(m_LodSettings.MidInterval, 1) == 0;
+	case EBoidsLod::Far:
+		return (StepIndex + Index) % FMath::Max(m_LodSettings.FarInterval, 1) == 0;
+	case EBoidsLod::Asleep:
+		return false;
+	default:
+		return true;
+	}
+}
+
+void FBoidsFlockSimulation::GatherNeighbors(int32 Index, EBoidsLod Lod, const FBoidsFlockState& Previous, FBoidsNeighborBuffer& Neighbors) const
+{
+	const FVector Position = Previous.Positions[Index];
+
+	// Neighbors are read from the previous state only, so the result does not depend on the step order
+	Neighbors.Reset();
+
+	if (Lod == EBoidsLod::Far)
+	{
+		const double RadiusSquared = FMath::Square(m_Settings.PerceptionRadius);
+		const int32 MaxNeighbors = m_LodSettings.FarMaxNeighbors;
+
+		m_Grid.ForEachInCell(Position, [Index, &Position, &Previous, &Neighbors, RadiusSquared, MaxNeighbors](int32 Neighbor, const FVector& NeighborPosition)
+		{
+			if (Neighbor != Index && FVector::DistSquared(Position, NeighborPosition) <= RadiusSquared)
+			{
+				Neighbors.Add(NeighborPosition - Position, Previous.Velocities[Neighbor]);
+			}
+			return Neighbors.Num < MaxNeighbors;
+		});
+		return;
+	}
+
+	GatherGridNeighbors(m_Grid, m_Settings, Index, Previous.Positions, Previous.Velocities, Neighbors);
+}
+
+void FBoidsFlockSimulation::GatherGridNeighbors(const FBoidsSpatialGrid& Grid, const FBoidsSettings& Settings, int32 Index, TConstArrayView<FVector> Positions, TConstArrayView<FVector> Velocities, FBoidsNeighborBuffer& Neighbors)
+{
+	const FVector Position = Positions[Index];
+
+	// Topological neighbors bound the rules to the k closest boids, however dense the flock gets
+	if (Settings.TopologicalNeighbors > 0)
+	{
+		FBoidsNearestNeighbors Nearest;
+		Nearest.Reset(Settings.TopologicalNeighbors);
+		Grid.FindNearest(Position, Settings.PerceptionRadius, Index, Nearest);
+
+		for (const FBoidsNearestNeighbors::FEntry& Entry : Nearest.Entries)
+		{
+			Neighbors.Add(Positions[Entry.Index] - Position, Velocities[Entry.Index]);
+		}
+		return;
+	}
+
+	const auto AddNeighbor = [Index, &Position, &Velocities, &Neighbors](int32 Neighbor, const FVector& NeighborPosition)
+	{
+		if (Neighbor != Index)
+		{
+			Neighbors.Add(NeighborPosition - Position, Velocities[Neighbor]);
+		}
+	};
+
+	if (!Grid.HasAggregates())
+	{
+		Grid.ForEachInRadius(Position, Settings.PerceptionRadius, AddNeighbor);
+		return;
+	}
+
+	// Distant cells only add their sums, cohesion and alignment stay exact, separation treats each cell as its center of mass
+	const float FarRadius = Settings.PerceptionRadius;
+	Grid.ForEachInRadiusAggregated(Position, FarRadius, AddNeighbor, [&Position, &Neighbors, FarRadius](const FBoidsCellAggregate& Aggregate)
+	{
+		const FVector CenterOffset = Aggregate.GetCenterOfMass() - Position;
+
+		FBoidsSteeringSums& FarField = Neighbors.FarField;
+		FarField.FarSeparation -= CenterOffset * (CenterOffset.Size() / FarRadius) * Aggregate.Num;
+		FarField.Heading += Aggregate.HeadingSum;
+		FarField.Velocity += Aggregate.VelocitySum;
+		FarField.Offset += Aggregate.PositionSum - Position * Aggregate.Num;
+		FarField.Num += Aggregate.Num;
+	});
+}
+
+void FBoidsFlockSimulation::StepBoid(int32 Index, float DeltaTime, EBoidsLod Lod, const FBoidsAvoidance& AvoidanceInput, const FBoidsFlockState& Previous, FBoidsFlockState& Next, FBoidsNeighborBuffer& Neighbors) const
+{
+	FVector Position = Previous.Positions[Index];
+	FVector Velocity = Previous.Velocities[Index];
+
+	// A baked field replaces the scene queries with one trilinear lookup, far boids avoid nothing
+	FBoidsAvoidance FieldAvoidance;
+	float ObstacleDistance = 0.0f;
+	FVector ObstacleGradient = FVector::ZeroVector;
+	if (m_DistanceField && Lod != EBoidsLod::Far && m_DistanceField->Sample(Position, ObstacleDistance, ObstacleGradient))
+	{
+		FieldAvoidance.AddFieldSample(ObstacleDistance, ObstacleGradient, m_Settings.AvoidanceWeight);
+		FieldAvoidance.Finalize();
+	}
+	const FBoidsAvoidance& Avoidance = m_DistanceField || Lod == EBoidsLod::Far ? FieldAvoidance : AvoidanceInput;
+
+	// Every rule reads these sums, the neighbors are only walked once
+	FBoidsSteeringSums Sums = FBoidsRules::GatherSums(Neighbors, m_Settings);
+	Sums.Influence = m_Influences.GetForce(Index);
+	// Workers cannot share the global random generator, each boid draws from its own stream
+	FBoidsRandom Random(m_Seed, Index, m_StepIndex);
+	FBoidsRules::Integrate(m_Settings, Sums, Avoidance, Random, DeltaTime, Position, Velocity);
+
+	Next.Positions[Index] = Position;
+	Next.Velocities[Index] = Velocity;
+}
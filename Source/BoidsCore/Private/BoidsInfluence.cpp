@@ -0,0 +1,28 @@
+#include "BoidsInfluence.h"
+
+void FBoidsInfluenceField::Evaluate(const FBoidsSpatialGrid& Grid, int32 NumBoids)
+{
+	for (const int32 Index : m_Influenced)
+	{
+		if (m_Forces.IsValidIndex(Index))
+		{
+			m_Forces[Index] = FVector::ZeroVector;
+		}
+	}
+	m_Influenced.Reset();
+
+	// Only the slots added by a larger flock need zeroing, the others were just cleared
+	if (m_Forces.Num() != NumBoids)
+	{
+		m_Forces.SetNumZeroed(NumBoids);
+	}
+
+	for (const FBoidsInfluence& Source : m_Sources)
+	{
+		Grid.ForEachInRadius(Source.Position, Source.Radius, [this, &Source](int32 Index, const FVector& Position)
+		{
+			m_Forces[Index] += Source.GetForce(Position);
+			m_Influenced.Add(Index);
+		});
+	}
+}
@@ -0,0 +1,34 @@
+#include "BoidsKeyframe.h"
+#include "BoidsQuantization.h"
+
+void FBoidsKeyframe::Encode(const FBoidsFlockState& State, int32 FirstBoid, int32 NumBoids, const FVector& Origin, const FVector& Extent, TArray<uint8>& OutData)
+{
+	FirstBoid = FMath::Clamp(FirstBoid, 0, State.Num());
+	NumBoids = FMath::Clamp(NumBoids, 0, State.Num() - FirstBoid);
+	OutData.SetNumUninitialized(NumBoids * BoidSize, EAllowShrinking::No);
+
+	// Boids leaving the box are clamped to its faces, the receiver corrects them on the next keyframe
+	const FVector3f BoxMin(Origin - Extent);
+	const FVector3f BoxSize(Extent * 2.0);
+
+	uint8* Boid = OutData.GetData();
+	for (int32 i = FirstBoid; i < FirstBoid + NumBoids; i++, Boid += BoidSize)
+	{
+		uint16 Quantized[3];
+		FBoidsQuantization::EncodePosition(FVector3f(State.Positions[i]), BoxMin, BoxSize, Quantized);
+		FMemory::Memcpy(Boid, Quantized, sizeof(Quantized));
+
+		FBoidsQuantization::EncodeHeading(FVector3f(State.Velocities[i]), Boid + 6);
+	}
+}
+
+void FBoidsKeyframe::DecodeBoid(TConstArrayView<uint8> Data, int32 Index, const FVector& Origin, const FVector& Extent, FVector& OutPosition, FVector& OutHeading)
+{
+	const uint8* Boid = Data.GetData() + Index * BoidSize;
+
+	uint16 Quantized[3];
+	FMemory::Memcpy(Quantized, Boid, sizeof(Quantized));
+
+	OutPosition = FVector(FBoidsQuantization::DecodePosition(Quantized, FVector3f(Origin - Extent), FVector3f(Extent * 2.0)));
+	OutHeading = FVector(FBoidsQuantization::DecodeHeading(Boid + 6));
+}
@@ -0,0 +1,225 @@
+#include "BoidsReplay.h"
+#include "BoidsQuantization.h"
+#include "Algo/BinarySearch.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+
+FBoidsReplayWriter::~FBoidsReplayWriter()
+{
+	Close();
+}
+
+bool FBoidsReplayWriter::Open(const FString& Path, int32 NumBoids)
+{
+	Close();
+
+	m_Archive.Reset(IFileManager::Get().CreateFileWriter(*Path));
+	if (!m_Archive)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Could not create the boids replay %s."), *Path);
+		return false;
+	}
+
+	m_NumBoids = NumBoids;
+	m_NumFrames = 0;
+	m_FrameBuffer.SetNumUninitialized(FBoidsReplayFormat::GetFrameSize(NumBoids));
+
+	uint32 Magic = FBoidsReplayFormat::Magic;
+	uint32 Version = FBoidsReplayFormat::Version;
+	*m_Archive << Magic << Version << m_NumBoids << m_NumFrames;
+	return true;
+}
+
+void FBoidsReplayWriter::WriteFrame(float Time, const FBoidsFlockState& State, int32 NumActive)
+{
+	if (!m_Archive || State.Num() != m_NumBoids)
+	{
+		return;
+	}
+
+	NumActive = FMath::Clamp(NumActive, 0, m_NumBoids);
+
+	FBox3f Bounds(ForceInit);
+	for (int32 i = 0; i < NumActive; i++)
+	{
+		Bounds += FVector3f(State.Positions[i]);
+	}
+	const FVector3f BoundsMin = NumActive > 0 ? Bounds.Min : FVector3f::ZeroVector;
+	const FVector3f BoundsSize = NumActive > 0 ? Bounds.GetSize() : FVector3f::ZeroVector;
+
+	uint8* Data = m_FrameBuffer.GetData();
+	FMemory::Memcpy(Data, &Time, sizeof(float));
+	FMemory::Memcpy(Data + 4, &BoundsMin, sizeof(FVector3f));
+	FMemory::Memcpy(Data + 16, &BoundsSize, sizeof(FVector3f));
+	FMemory::Memcpy(Data + 28, &NumActive, sizeof(int32));
+
+	// Frames keep the size of the whole pool, so they stay addressable without an index
+	uint8* Boid = Data + FBoidsReplayFormat::FrameHeaderSize;
+	FMemory::Memzero(Boid + FBoidsReplayFormat::BoidSize * NumActive, FBoidsReplayFormat::BoidSize * (m_NumBoids - NumActive));
+	for (int32 i = 0; i < NumActive; i++, Boid += FBoidsReplayFormat::BoidSize)
+	{
+		uint16 Quantized[3];
+		FBoidsQuantization::EncodePosition(FVector3f(State.Positions[i]), BoundsMin, BoundsSize, Quantized);
+		FMemory::Memcpy(Boid, Quantized, sizeof(Quantized));
+
+		FBoidsQuantization::EncodeHeading(FVector3f(State.Velocities[i]), Boid + 6);
+	}
+
+	m_Archive->Serialize(Data, m_FrameBuffer.Num());
+	m_NumFrames++;
+}
+
+void FBoidsReplayWriter::Close()
+{
+	if (!m_Archive)
+	{
+		return;
+	}
+
+	// The frame count is only known once the recording ends
+	m_Archive->Seek(FBoidsReplayFormat::NumFramesOffset);
+	*m_Archive << m_NumFrames;
+	m_Archive->Close();
+	m_Archive.Reset();
+}
+
+FBoidsReplayReader::~FBoidsReplayReader()
+{
+	m_File.Reset();
+}
+
+bool FBoidsReplayReader::Open(const FString& Path)
+{
+	m_File.Reset();
+	m_FrameTimes.Reset();
+	m_FrameBoundsMin.Reset();
+	m_FrameBoundsSize.Reset();
+	m_FrameNumActive.Reset();
+	m_LoadedFrames[0] = m_LoadedFrames[1] = INDEX_NONE;
+	m_NumBoids = 0;
+
+	m_File.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*Path));
+	uint32 Header[4];
+	if (!m_File || !m_File->Read(reinterpret_cast<uint8*>(Header), sizeof(Header)))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Could not read the boids replay %s."), *Path);
+		m_File.Reset();
+		return false;
+	}
+
+	const int32 NumBoids = int32(Header[2]);
+	const int32 NumFrames = int32(Header[3]);
+	if (Header[0] != FBoidsReplayFormat::Magic || Header[1] != FBoidsReplayFormat::Version || NumBoids < 0 || NumFrames < 0 ||
+		m_File->Size() < FBoidsReplayFormat::HeaderSize + FBoidsReplayFormat::GetFrameSize(NumBoids) * NumFrames)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s is not a valid boids replay."), *Path);
+		m_File.Reset();
+		return false;
+	}
+
+	m_NumBoids = NumBoids;
+	m_FrameTimes.SetNumUninitialized(NumFrames);
+	m_FrameBoundsMin.SetNumUninitialized(NumFrames);
+	m_FrameBoundsSize.SetNumUninitialized(NumFrames);
+	m_FrameNumActive.SetNumUninitialized(NumFrames);
+
+	// Frames have a fixed size, each header is read where it sits and the boids are skipped
+	for (int32 Frame = 0; Frame < NumFrames; Frame++)
+	{
+		uint8 FrameHeader[FBoidsReplayFormat::FrameHeaderSize];
+		if (!m_File->Seek(FBoidsReplayFormat::HeaderSize + FBoidsReplayFormat::GetFrameSize(m_NumBoids) * Frame) || !m_File->Read(FrameHeader, sizeof(FrameHeader)))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Could not read frame %d of the boids replay %s."), Frame, *Path);
+			m_File.Reset();
+			m_FrameTimes.Reset();
+			return false;
+		}
+
+		FMemory::Memcpy(&m_FrameTimes[Frame], FrameHeader, sizeof(float));
+		FMemory::Memcpy(&m_FrameBoundsMin[Frame], FrameHeader + 4, sizeof(FVector3f));
+		FMemory::Memcpy(&m_FrameBoundsSize[Frame], FrameHeader + 16, sizeof(FVector3f));
+		FMemory::Memcpy(&m_FrameNumActive[Frame], FrameHeader + 28, sizeof(int32));
+		m_FrameNumActive[Frame] = FMath::Clamp(m_FrameNumActive[Frame], 0, m_NumBoids);
+	}
+
+	return true;
+}
+
+int32 FBoidsReplayReader::Sample(float Time, FBoidsFlockState& OutState)
+{
+	OutState.SetNum(m_NumBoids);
+	if (m_FrameTimes.Num() == 0)
+	{
+		return 0;
+	}
+
+	// Last frame recorded at or before Time, blended with the next one
+	const int32 Frame = FMath::Clamp(Algo::UpperBound(m_FrameTimes, Time) - 1, 0, m_FrameTimes.Num() - 1);
+	const int32 NextFrame = FMath::Min(Frame + 1, m_FrameTimes.Num() - 1);
+	const float FrameDuration = m_FrameTimes[NextFrame] - m_FrameTimes[Frame];
+	const float Alpha = FrameDuration > 0.0f ? FMath::Clamp((Time - m_FrameTimes[Frame]) / FrameDuration, 0.0f, 1.0f) : 0.0f;
+	if (!LoadFrame(Frame) || !LoadFrame(NextFrame))
+	{
+		return 0;
+	}
+
+	// Boids spawned or despawned between the two frames are not blended
+	const int32 NumActive = m_FrameNumActive[Frame];
+	const int32 NumBlended = FMath::Min(NumActive, m_FrameNumActive[NextFrame]);
+	for (int32 i = 0; i < NumActive; i++)
+	{
+		FVector Position;
+		FVector Heading;
+		DecodeBoid(Frame, i, Position, Heading);
+
+		if (i < NumBlended)
+		{
+			FVector NextPosition;
+			FVector NextHeading;
+			DecodeBoid(NextFrame, i, NextPosition, NextHeading);
+			Position = FMath::Lerp(Position, NextPosition, Alpha);
+			Heading = FMath::Lerp(Heading, NextHeading, Alpha);
+		}
+
+		OutState.Positions[i] = Position;
+		OutState.Velocities[i] = Heading;
+	}
+
+	return NumActive;
+}
+
+bool FBoidsReplayReader::LoadFrame(int32 Frame)
+{
+	const int32 Buffer = Frame & 1;
+	if (m_LoadedFrames[Buffer] == Frame)
+	{
+		return true;
+	}
+
+	// Pooled boids are zeroed in the file, only the active ones are read
+	TArray<uint8>& Data = m_FrameBuffers[Buffer];
+	Data.SetNumUninitialized(FBoidsReplayFormat::BoidSize * m_FrameNumActive[Frame], EAllowShrinking::No);
+	m_LoadedFrames[Buffer] = INDEX_NONE;
+
+	const int64 Offset = FBoidsReplayFormat::HeaderSize + FBoidsReplayFormat::GetFrameSize(m_NumBoids) * Frame + FBoidsReplayFormat::FrameHeaderSize;
+	if (!m_File || !m_File->Seek(Offset) || !m_File->Read(Data.GetData(), Data.Num()))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Could not read frame %d of the boids replay."), Frame);
+		return false;
+	}
+
+	m_LoadedFrames[Buffer] = Frame;
+	return true;
+}
+
+void FBoidsReplayReader::DecodeBoid(int32 Frame, int32 Boid, FVector& OutPosition, FVector& OutHeading) const
+{
+	const uint8* Data = m_FrameBuffers[Frame & 1].GetData() + FBoidsReplayFormat::BoidSize * Boid;
+
+	uint16 Quantized[3];
+	FMemory::Memcpy(Quantized, Data, sizeof(Quantized));
+
+	OutPosition = FVector(FBoidsQuantization::DecodePosition(Quantized, m_FrameBoundsMin[Frame], m_FrameBoundsSize[Frame]));
+	OutHeading = FVector(FBoidsQuantization::DecodeHeading(Data + 6));
+}
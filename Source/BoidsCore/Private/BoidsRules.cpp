@@ -0,0 +1,109 @@
+#include "BoidsRules.h"
+
+FBoidsSteeringSums FBoidsRules::GatherSums(FBoidsNeighborBuffer& Neighbors, const FBoidsSettings& Settings)
+{
+	Neighbors.Pad();
+	return FBoidsSteeringKernel::Accumulate(Neighbors, SeparationDistance, Settings.PerceptionRadius);
+}
+
+void FBoidsRules::Integrate(const FBoidsSettings& Settings, const FBoidsSteeringSums& Sums, const FBoidsAvoidance& Avoidance, FBoidsRandom& Random, float DeltaTime, FVector& Position, FVector& Velocity)
+{
+	const float InvNumNeighbors = Sums.Num > 0 ? 1.0f / Sums.Num : 0.0f;
+
+	// Separation
+	{
+		FVector Direction = Velocity.GetSafeNormal() + Sums.NearSeparation * Settings.SeparationWeight;
+		if (!Direction.IsNearlyZero())
+		{
+			Direction.Normalize();
+		}
+
+		Velocity = Direction * Velocity.Size();
+	}
+
+	// Obstacle avoidance
+	if (Avoidance.bDetected)
+	{
+		const FVector Direction = Velocity.GetSafeNormal() + Avoidance.Steer;
+		if (!Direction.IsNearlyZero())
+		{
+			Velocity = Direction.GetUnsafeNormal() * Velocity.Size();
+		}
+	}
+
+	// Alignment
+	if (Sums.Num > 0)
+	{
+		const FVector Direction = (Velocity.GetSafeNormal() + Sums.Heading * InvNumNeighbors * Settings.AlignmentWeight).GetSafeNormal();
+		Velocity = Direction * Velocity.Size();
+	}
+
+	// Cohesion
+	if (Settings.bApplyCohesion && Sums.Num > 0)
+	{
+		const FVector ToCenterVector = Sums.Offset * InvNumNeighbors;
+		const float Distance = ToCenterVector.Size();
+		const float MaxDistance = 300.0f;
+
+		if (Distance > 0.0f && Distance < MaxDistance)
+		{
+			FVector Direction = Velocity.GetSafeNormal() + ToCenterVector.GetSafeNormal() * (Distance / MaxDistance) * Settings.CohesionWeight;
+			if (!Direction.IsNearlyZero())
+			{
+				Direction.Normalize();
+			}
+			Velocity = Direction * Velocity.Size();
+		}
+	}
+
+	// Wander
+	if (Settings.bApplyWander && Random.FRand() < 0.3f)
+	{
+		const FVector Direction = Velocity.GetSafeNormal();
+		const FRotator RandomRotation(Random.FRandRange(-10.0f, 10.0f), Random.FRandRange(-20.0f, 20.0f), 0.0f);
+
+		FVector WanderedDirection = Direction + RandomRotation.RotateVector(Direction) * 0.1f * Settings.WanderWeight;
+		if (!WanderedDirection.IsNearlyZero())
+		{
+			WanderedDirection.Normalize();
+		}
+		Velocity = WanderedDirection * Velocity.Size();
+	}
+
+	Velocity = Velocity.GetClampedToSize(Settings.MinSpeed, Settings.MaxSpeed);
+
+	// A single integration leaves the boid in place until the steering forces are applied
+	const FVector Displacement = Settings.bSingleIntegration ? FVector::ZeroVector : Velocity * DeltaTime;
+	Position += Displacement;
+
+	// Steering forces, the separation sum is taken from the position before the first move
+	FVector SeparationForce = FVector::ZeroVector;
+	FVector AlignmentForce = FVector::ZeroVector;
+	FVector CohesionForce = FVector::ZeroVector;
+
+	if (Sums.Num > 0)
+	{
+		SeparationForce = Sums.FarSeparation.GetSafeNormal();
+		AlignmentForce = Sums.Velocity * InvNumNeighbors - Velocity;
+		CohesionForce = Sums.Offset * InvNumNeighbors - Displacement;
+	}
+
+	const FVector WanderForce = FRotator(0.0f, Random.FRandRange(-30.0f, 30.0f), 0.0f).RotateVector(Velocity.GetSafeNormal()) * 0.1f;
+
+	const FVector SteeringForce = SeparationForce * Settings.SeparationWeight +
+		AlignmentForce * Settings.AlignmentWeight +
+		CohesionForce * Settings.CohesionWeight +
+		Avoidance.Force * Settings.AvoidanceWeight +
+		WanderForce * Settings.WanderWeight +
+		Sums.Influence;
+
+	Velocity += SteeringForce * DeltaTime;
+	Velocity = Velocity.GetClampedToSize(Settings.MinSpeed, Settings.MaxSpeed);
+	Position += Velocity * DeltaTime;
+}
+
+void FBoidsRules::Extrapolate(const FBoidsSettings& Settings, float DeltaTime, const FVector& Velocity, FVector& Position)
+{
+	// Unless single integration is set, Integrate moves the boid once before and once after the steering forces
+	Position += Velocity * (Settings.bSingleIntegration ? DeltaTime : 2.0f * DeltaTime);
+}
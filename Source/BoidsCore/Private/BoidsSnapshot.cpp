@@ -0,0 +1,170 @@
+#include "BoidsSnapshot.h"
+#include "BoidsFlockSimulation.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+
+bool FBoidsSnapshot::Save(const FString& Path, const FBoidsFlockSimulation& Simulation)
+{
+	const FBoidsFlockState& State = Simulation.GetState();
+	const FBoidsSettings& Settings = Simulation.GetSettings();
+	const int64 ArraySize = int64(Simulation.GetNumActive()) * sizeof(FVector);
+
+	// Only the active boids are saved, pooled slots hold no state worth keeping
+	FBoidsSnapshotHeader Header;
+	Header.NumBoids = Simulation.GetNumActive();
+	Header.Seed = Simulation.GetSeed();
+	Header.StepIndex = Simulation.GetStepIndex();
+	Header.Flags = (Settings.bApplyCohesion ? FBoidsSnapshotHeader::ApplyCohesionFlag : 0)
+		| (Settings.bApplyWander ? FBoidsSnapshotHeader::ApplyWanderFlag : 0)
+		| (Settings.bSingleIntegration ? FBoidsSnapshotHeader::SingleIntegrationFlag : 0);
+	Header.MaxSpeed = Settings.MaxSpeed;
+	Header.MinSpeed = Settings.MinSpeed;
+	Header.PerceptionRadius = Settings.PerceptionRadius;
+	Header.AlignmentWeight = Settings.AlignmentWeight;
+	Header.CohesionWeight = Settings.CohesionWeight;
+	Header.SeparationWeight = Settings.SeparationWeight;
+	Header.SeparationRadius = Settings.SeparationRadius;
+	Header.AvoidanceWeight = Settings.AvoidanceWeight;
+	Header.TopologicalNeighbors = Settings.TopologicalNeighbors;
+	Header.FarFieldRadius = Settings.FarFieldRadius;
+	Header.WanderWeight[0] = Settings.WanderWeight.X;
+	Header.WanderWeight[1] = Settings.WanderWeight.Y;
+	Header.WanderWeight[2] = Settings.WanderWeight.Z;
+	Header.PositionsOffset = Align(int64(sizeof(FBoidsSnapshotHeader)), FBoidsSnapshotHeader::Alignment);
+	Header.VelocitiesOffset = Align(Header.PositionsOffset + ArraySize, FBoidsSnapshotHeader::Alignment);
+
+	TUniquePtr<FArchive> Archive(IFileManager::Get().CreateFileWriter(*Path));
+	if (!Archive)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Could not create the flock snapshot %s."), *Path);
+		return false;
+	}
+
+	// Zero padding between the blocks keeps every array on its alignment
+	uint8 Padding[FBoidsSnapshotHeader::Alignment] = {};
+
+	Archive->Serialize(&Header, sizeof(Header));
+	Archive->Serialize(Padding, Header.PositionsOffset - sizeof(Header));
+	Archive->Serialize(const_cast<FVector*>(State.Positions.GetData()), ArraySize);
+	Archive->Serialize(Padding, Header.VelocitiesOffset - Header.PositionsOffset - ArraySize);
+	Archive->Serialize(const_cast<FVector*>(State.Velocities.GetData()), ArraySize);
+
+	return Archive->Close();
+}
+
+FBoidsSnapshot::~FBoidsSnapshot()
+{
+	Close();
+}
+
+bool FBoidsSnapshot::Open(const FString& Path)
+{
+	Close();
+
+	if (!IFileManager::Get().FileExists(*Path))
+	{
+		return false;
+	}
+
+	m_MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Path));
+	if (m_MappedFile)
+	{
+		m_MappedRegion.Reset(m_MappedFile->MapRegion(0, m_MappedFile->GetFileSize()));
+	}
+
+	if (m_MappedRegion)
+	{
+		return SetData(m_MappedRegion->GetMappedPtr(), m_MappedRegion->GetMappedSize(), Path);
+	}
+
+	if (!FFileHelper::LoadFileToArray(m_LoadedData, *Path))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Could not read the flock snapshot %s."), *Path);
+		return false;
+	}
+
+	return SetData(m_LoadedData.GetData(), m_LoadedData.Num(), Path);
+}
+
+void FBoidsSnapshot::Close()
+{
+	m_Data = nullptr;
+	m_Header = FBoidsSnapshotHeader();
+	m_MappedRegion.Reset();
+	m_MappedFile.Reset();
+	m_LoadedData.Empty();
+}
+
+bool FBoidsSnapshot::SetData(const uint8* Data, int64 Size, const FString& Path)
+{
+	if (Size < int64(sizeof(FBoidsSnapshotHeader)))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s is not a valid flock snapshot."), *Path);
+		Close();
+		return false;
+	}
+
+	FMemory::Memcpy(&m_Header, Data, sizeof(FBoidsSnapshotHeader));
+
+	const int64 ArraySize = int64(m_Header.NumBoids) * sizeof(FVector);
+	if (m_Header.Magic != FBoidsSnapshotHeader::FileMagic || m_Header.Version != FBoidsSnapshotHeader::FileVersion || m_Header.NumBoids < 0 ||
+		!IsAligned(m_Header.PositionsOffset, FBoidsSnapshotHeader::Alignment) || !IsAligned(m_Header.VelocitiesOffset, FBoidsSnapshotHeader::Alignment) ||
+		m_Header.PositionsOffset < int64(sizeof(FBoidsSnapshotHeader)) || m_Header.PositionsOffset + ArraySize > Size || m_Header.VelocitiesOffset + ArraySize > Size)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s is not a valid flock snapshot."), *Path);
+		Close();
+		return false;
+	}
+
+	m_Data = Data;
+	return true;
+}
+
+FBoidsSettings FBoidsSnapshot::GetSettings() const
+{
+	FBoidsSettings Settings;
+	Settings.MaxSpeed = m_Header.MaxSpeed;
+	Settings.MinSpeed = m_Header.MinSpeed;
+	Settings.PerceptionRadius = m_Header.PerceptionRadius;
+	Settings.AlignmentWeight = m_Header.AlignmentWeight;
+	Settings.CohesionWeight = m_Header.CohesionWeight;
+	Settings.SeparationWeight = m_Header.SeparationWeight;
+	Settings.SeparationRadius = m_Header.SeparationRadius;
+	Settings.AvoidanceWeight = m_Header.AvoidanceWeight;
+	Settings.TopologicalNeighbors = m_Header.TopologicalNeighbors;
+	Settings.FarFieldRadius = m_Header.FarFieldRadius;
+	Settings.WanderWeight = FVector(m_Header.WanderWeight[0], m_Header.WanderWeight[1], m_Header.WanderWeight[2]);
+	Settings.bApplyCohesion = (m_Header.Flags & FBoidsSnapshotHeader::ApplyCohesionFlag) != 0;
+	Settings.bApplyWander = (m_Header.Flags & FBoidsSnapshotHeader::ApplyWanderFlag) != 0;
+	Settings.bSingleIntegration = (m_Header.Flags & FBoidsSnapshotHeader::SingleIntegrationFlag) != 0;
+	return Settings;
+}
+
+TConstArrayView<FVector> FBoidsSnapshot::GetPositions() const
+{
+	if (!m_Data)
+	{
+		return TConstArrayView<FVector>();
+	}
+
+	return TConstArrayView<FVector>(reinterpret_cast<const FVector*>(m_Data + m_Header.PositionsOffset), m_Header.NumBoids);
+}
+
+void FBoidsSnapshot::Restore(FBoidsFlockSimulation& Simulation) const
+{
+	FBoidsFlockState& State = Simulation.GetState();
+	if (!m_Data || State.Num() < m_Header.NumBoids)
+	{
+		return;
+	}
+
+	const int64 ArraySize = int64(m_Header.NumBoids) * sizeof(FVector);
+	FMemory::Memcpy(State.Positions.GetData(), m_Data + m_Header.PositionsOffset, ArraySize);
+	FMemory::Memcpy(State.Velocities.GetData(), m_Data + m_Header.VelocitiesOffset, ArraySize);
+
+	Simulation.SetNumActive(m_Header.NumBoids);
+	Simulation.SetStepIndex(m_Header.StepIndex);
+	Simulation.CopyStateToPrevious();
+}
@@ -0,0 +1,104 @@
+#include "BoidsSpatialGrid.h"
+
+void FBoidsSpatialGrid::Build(TConstArrayView<FVector> Positions, float CellSize)
+{
+	m_CellSize = FMath::Max(CellSize, 1.0f);
+	m_InvCellSize = 1.0f / m_CellSize;
+
+	m_Cells.Reset();
+	m_NumAggregateLevels = 0;
+	m_PointCells.SetNumUninitialized(Positions.Num(), EAllowShrinking::No);
+	m_SortedIndices.SetNumUninitialized(Positions.Num(), EAllowShrinking::No);
+	m_SortedPositions.SetNumUninitialized(Positions.Num(), EAllowShrinking::No);
+
+	// Count the points falling in each cell
+	for (int32 i = 0; i < Positions.Num(); i++)
+	{
+		m_PointCells[i] = GetCell(Positions[i]);
+		m_Cells.FindOrAdd(m_PointCells[i], FIntPoint(0, 0)).Y++;
+	}
+
+	// Turn the counts into the first slot of each cell
+	int32 Offset = 0;
+	for (TPair<FIntVector, FIntPoint>& Cell : m_Cells)
+	{
+		Cell.Value.X = Offset;
+		Offset += Cell.Value.Y;
+		Cell.Value.Y = 0;
+	}
+
+	// Scatter the points into their cell range
+	for (int32 i = 0; i < Positions.Num(); i++)
+	{
+		FIntPoint& Cell = m_Cells.FindChecked(m_PointCells[i]);
+		const int32 Slot = Cell.X + Cell.Y++;
+		m_SortedIndices[Slot] = i;
+		m_SortedPositions[Slot] = Positions[i];
+	}
+}
+
+void FBoidsSpatialGrid::BuildAggregates(TConstArrayView<FVector> Velocities, float Radius)
+{
+	// Levels double in size until the top one is as wide as the query radius
+	const uint32 CellsPerRadius = uint32(FMath::Max(FMath::CeilToInt32(Radius * m_InvCellSize), 1));
+	m_NumAggregateLevels = int32(FMath::CeilLogTwo(CellsPerRadius)) + 1;
+	if (m_AggregateLevels.Num() < m_NumAggregateLevels)
+	{
+		m_AggregateLevels.SetNum(m_NumAggregateLevels);
+	}
+
+	TMap<FIntVector, FBoidsCellAggregate>& Cells = m_AggregateLevels[0];
+	Cells.Reset();
+	for (const TPair<FIntVector, FIntPoint>& Cell : m_Cells)
+	{
+		FBoidsCellAggregate& Aggregate = Cells.Add(Cell.Key);
+		const int32 End = Cell.Value.X + Cell.Value.Y;
+		for (int32 Slot = Cell.Value.X; Slot < End; Slot++)
+		{
+			const FVector& Velocity = Velocities[m_SortedIndices[Slot]];
+			Aggregate.PositionSum += m_SortedPositions[Slot];
+			Aggregate.VelocitySum += Velocity;
+			Aggregate.HeadingSum += Velocity.GetSafeNormal();
+		}
+		Aggregate.Num = Cell.Value.Y;
+	}
+
+	// Each level sums the eight children below it
+	for (int32 Level = 1; Level < m_NumAggregateLevels; Level++)
+	{
+		TMap<FIntVector, FBoidsCellAggregate>& Parents = m_AggregateLevels[Level];
+		Parents.Reset();
+		for (const TPair<FIntVector, FBoidsCellAggregate>& Child : m_AggregateLevels[Level - 1])
+		{
+			Parents.FindOrAdd(GetParentCell(Child.Key, 1)).Add(Child.Value);
+		}
+	}
+}
+
+void FBoidsSpatialGrid::Reset()
+{
+	m_Cells.Reset();
+	m_NumAggregateLevels = 0;
+	m_SortedIndices.Reset();
+	m_SortedPositions.Reset();
+}
+
+void FBoidsSpatialGrid::FindNearest(const FVector& Center, float Radius, int32 ExcludeIndex, FBoidsNearestNeighbors& Nearest) const
+{
+	ForEachInRadius(Center, Radius, [&Center, ExcludeIndex, &Nearest](int32 Index, const FVector& Position)
+	{
+		if (Index != ExcludeIndex)
+		{
+			Nearest.Offer(Index, FVector::DistSquared(Center, Position));
+		}
+	});
+}
+
+FIntVector FBoidsSpatialGrid::GetCell(const FVector& Position) const
+{
+	return FIntVector(
+		FMath::FloorToInt32(Position.X * m_InvCellSize),
+		FMath::FloorToInt32(Position.Y * m_InvCellSize),
+		FMath::FloorToInt32(Position.Z * m_InvCellSize)
+	);
+}
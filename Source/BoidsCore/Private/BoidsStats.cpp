@@ -0,0 +1,20 @@
+#include "BoidsStats.h"
+
+DEFINE_STAT(STAT_BoidsGridBuild);
+DEFINE_STAT(STAT_BoidsStep);
+DEFINE_STAT(STAT_BoidsStepChunk);
+DEFINE_STAT(STAT_BoidsFindNeighbors);
+DEFINE_STAT(STAT_BoidsSteering);
+DEFINE_STAT(STAT_BoidsObstacleAvoidance);
+DEFINE_STAT(STAT_BoidsMove);
+DEFINE_STAT(STAT_BoidsWriteBack);
+
+DEFINE_STAT(STAT_BoidsNum);
+DEFINE_STAT(STAT_BoidsStepped);
+DEFINE_STAT(STAT_BoidsDeferred);
+DEFINE_STAT(STAT_BoidsNeighbors);
+DEFINE_STAT(STAT_BoidsAverageNeighbors);
+DEFINE_STAT(STAT_BoidsMaxNeighbors);
+DEFINE_STAT(STAT_BoidsTracesIssued);
+
+UE_TRACE_CHANNEL_DEFINE(BoidsChannel);
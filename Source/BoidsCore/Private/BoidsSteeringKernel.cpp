@@ -0,0 +1,128 @@
+#include "BoidsSteeringKernel.h"
+#include "Templates/AlignmentTemplates.h"
+
+namespace
+{
+	constexpr int32 SimdWidth = 4;
+
+	// Sums the four lanes of a register
+	float HorizontalSum(const VectorRegister4Float& Vec)
+	{
+		alignas(16) float Lanes[SimdWidth];
+		VectorStoreAligned(Vec, Lanes);
+		return Lanes[0] + Lanes[1] + Lanes[2] + Lanes[3];
+	}
+
+	FVector HorizontalSum(const VectorRegister4Float& X, const VectorRegister4Float& Y, const VectorRegister4Float& Z)
+	{
+		return FVector(HorizontalSum(X), HorizontalSum(Y), HorizontalSum(Z));
+	}
+}
+
+void FBoidsNeighborBuffer::Reset()
+{
+	OffsetX.Reset();
+	OffsetY.Reset();
+	OffsetZ.Reset();
+	VelocityX.Reset();
+	VelocityY.Reset();
+	VelocityZ.Reset();
+	Num = 0;
+	FarField = FBoidsSteeringSums();
+}
+
+void FBoidsNeighborBuffer::Add(const FVector& Offset, const FVector& Velocity)
+{
+	OffsetX.Add(Offset.X);
+	OffsetY.Add(Offset.Y);
+	OffsetZ.Add(Offset.Z);
+	VelocityX.Add(Velocity.X);
+	VelocityY.Add(Velocity.Y);
+	VelocityZ.Add(Velocity.Z);
+	Num++;
+}
+
+void FBoidsNeighborBuffer::Pad()
+{
+	const int32 PaddedNum = Align(Num, SimdWidth);
+
+	OffsetX.SetNumZeroed(PaddedNum);
+	OffsetY.SetNumZeroed(PaddedNum);
+	OffsetZ.SetNumZeroed(PaddedNum);
+	VelocityX.SetNumZeroed(PaddedNum);
+	VelocityY.SetNumZeroed(PaddedNum);
+	VelocityZ.SetNumZeroed(PaddedNum);
+}
+
+FBoidsSteeringSums FBoidsSteeringKernel::Accumulate(const FBoidsNeighborBuffer& Neighbors, float NearRadius, float FarRadius)
+{
+	check(Neighbors.OffsetX.Num() % SimdWidth == 0);
+
+	const VectorRegister4Float Zero = VectorZeroFloat();
+	const VectorRegister4Float NearRadiusVec = VectorSetFloat1(NearRadius);
+	const VectorRegister4Float FarRadiusVec = VectorSetFloat1(FarRadius);
+	const VectorRegister4Float InvNearRadius = VectorSetFloat1(1.0f / NearRadius);
+	const VectorRegister4Float InvFarRadius = VectorSetFloat1(1.0f / FarRadius);
+	const VectorRegister4Float MinSizeSquared = VectorSetFloat1(SMALL_NUMBER);
+
+	VectorRegister4Float NearX = Zero, NearY = Zero, NearZ = Zero;
+	VectorRegister4Float FarX = Zero, FarY = Zero, FarZ = Zero;
+	VectorRegister4Float HeadingX = Zero, HeadingY = Zero, HeadingZ = Zero;
+	VectorRegister4Float VelocityX = Zero, VelocityY = Zero, VelocityZ = Zero;
+	VectorRegister4Float OffsetX = Zero, OffsetY = Zero, OffsetZ = Zero;
+
+	for (int32 i = 0; i < Neighbors.OffsetX.Num(); i += SimdWidth)
+	{
+		const VectorRegister4Float DX = VectorLoad(&Neighbors.OffsetX[i]);
+		const VectorRegister4Float DY = VectorLoad(&Neighbors.OffsetY[i]);
+		const VectorRegister4Float DZ = VectorLoad(&Neighbors.OffsetZ[i]);
+		const VectorRegister4Float VX = VectorLoad(&Neighbors.VelocityX[i]);
+		const VectorRegister4Float VY = VectorLoad(&Neighbors.VelocityY[i]);
+		const VectorRegister4Float VZ = VectorLoad(&Neighbors.VelocityZ[i]);
+
+		// Cohesion and alignment only need the plain sums
+		OffsetX = VectorAdd(OffsetX, DX);
+		OffsetY = VectorAdd(OffsetY, DY);
+		OffsetZ = VectorAdd(OffsetZ, DZ);
+		VelocityX = VectorAdd(VelocityX, VX);
+		VelocityY = VectorAdd(VelocityY, VY);
+		VelocityZ = VectorAdd(VelocityZ, VZ);
+
+		// Headings, zero velocities (and padding) contribute nothing
+		const VectorRegister4Float SpeedSquared = VectorMultiplyAdd(VX, VX, VectorMultiplyAdd(VY, VY, VectorMultiply(VZ, VZ)));
+		const VectorRegister4Float HasSpeed = VectorCompareGT(SpeedSquared, MinSizeSquared);
+		const VectorRegister4Float InvSpeed = VectorSelect(HasSpeed, VectorReciprocalSqrtAccurate(VectorMax(SpeedSquared, MinSizeSquared)), Zero);
+		HeadingX = VectorMultiplyAdd(VX, InvSpeed, HeadingX);
+		HeadingY = VectorMultiplyAdd(VY, InvSpeed, HeadingY);
+		HeadingZ = VectorMultiplyAdd(VZ, InvSpeed, HeadingZ);
+
+		// Separation pushes away from the neighbor, weighted by Distance / Radius
+		const VectorRegister4Float DistanceSquared = VectorMultiplyAdd(DX, DX, VectorMultiplyAdd(DY, DY, VectorMultiply(DZ, DZ)));
+		const VectorRegister4Float Distance = VectorSqrt(DistanceSquared);
+		const VectorRegister4Float IsApart = VectorCompareGT(Distance, Zero);
+
+		const VectorRegister4Float NearMask = VectorBitwiseAnd(IsApart, VectorCompareLT(Distance, NearRadiusVec));
+		const VectorRegister4Float NearRatio = VectorSelect(NearMask, VectorMultiply(Distance, InvNearRadius), Zero);
+		NearX = VectorNegateMultiplyAdd(DX, NearRatio, NearX);
+		NearY = VectorNegateMultiplyAdd(DY, NearRatio, NearY);
+		NearZ = VectorNegateMultiplyAdd(DZ, NearRatio, NearZ);
+
+		const VectorRegister4Float FarMask = VectorBitwiseAnd(IsApart, VectorCompareLT(Distance, FarRadiusVec));
+		const VectorRegister4Float FarRatio = VectorSelect(FarMask, VectorMultiply(Distance, InvFarRadius), Zero);
+		FarX = VectorNegateMultiplyAdd(DX, FarRatio, FarX);
+		FarY = VectorNegateMultiplyAdd(DY, FarRatio, FarY);
+		FarZ = VectorNegateMultiplyAdd(DZ, FarRatio, FarZ);
+	}
+
+	// Far-field sums come on top of the exact neighbors
+	const FBoidsSteeringSums& FarField = Neighbors.FarField;
+
+	FBoidsSteeringSums Sums;
+	Sums.NearSeparation = HorizontalSum(NearX, NearY, NearZ) + FarField.NearSeparation;
+	Sums.FarSeparation = HorizontalSum(FarX, FarY, FarZ) + FarField.FarSeparation;
+	Sums.Heading = HorizontalSum(HeadingX, HeadingY, HeadingZ) + FarField.Heading;
+	Sums.Velocity = HorizontalSum(VelocityX, VelocityY, VelocityZ) + FarField.Velocity;
+	Sums.Offset = HorizontalSum(OffsetX, OffsetY, OffsetZ) + FarField.Offset;
+	Sums.Num = Neighbors.Num + FarField.Num;
+	return Sums;
+}
@@ -0,0 +1,111 @@
+#include "BoidsFlockSimulation.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	// Same flock for a given seed, spawned like the benchmark
+	void InitializeFlock(FBoidsFlockSimulation& Simulation, const FBoidsSettings& Settings, int32 NumBoids, uint32 Seed, bool bParallel)
+	{
+		Simulation.Initialize(Settings, NumBoids);
+		Simulation.SetSeed(Seed);
+		Simulation.SetParallel(bParallel);
+
+		FRandomStream Random(int32(Seed));
+		FBoidsFlockState& State = Simulation.GetState();
+		for (int32 i = 0; i < NumBoids; i++)
+		{
+			State.Positions[i] = FVector(Random.FRandRange(-4000.0f, 4000.0f), Random.FRandRange(-4000.0f, 4000.0f), Random.FRandRange(-1600.0f, 1600.0f));
+			State.Velocities[i] = Random.GetUnitVector() * Settings.MinSpeed;
+		}
+		Simulation.CopyStateToPrevious();
+	}
+
+	// Steps a parallel and a serial copy of the same flock and checks both stay bit identical
+	bool RunParallelMatchesSerial(FAutomationTestBase& Test, const TCHAR* What, const FBoidsSettings& Settings)
+	{
+		constexpr int32 NumBoids = 3000;
+		constexpr int32 NumSteps = 40;
+		constexpr uint32 Seed = 0x5EED1234;
+
+		FBoidsFlockSimulation Parallel;
+		FBoidsFlockSimulation Serial;
+		InitializeFlock(Parallel, Settings, NumBoids, Seed, true);
+		InitializeFlock(Serial, Settings, NumBoids, Seed, false);
+
+		for (int32 Step = 0; Step < NumSteps; Step++)
+		{
+			Parallel.Step(1.0f / 60.0f, TConstArrayView<FBoidsAvoidance>());
+			Serial.Step(1.0f / 60.0f, TConstArrayView<FBoidsAvoidance>());
+
+			// Every boid reads the previous state only and draws from its own stream, the chunk order cannot show
+			const FBoidsFlockState& ParallelState = Parallel.GetState();
+			const FBoidsFlockState& SerialState = Serial.GetState();
+			if (FMemory::Memcmp(ParallelState.Positions.GetData(), SerialState.Positions.GetData(), NumBoids * sizeof(FVector)) != 0 ||
+				FMemory::Memcmp(ParallelState.Velocities.GetData(), SerialState.Velocities.GetData(), NumBoids * sizeof(FVector)) != 0)
+			{
+				Test.AddError(FString::Printf(TEXT("%s: parallel and serial flocks differ after step %d."), What, Step));
+				return false;
+			}
+		}
+
+		// Both copies stepped as many times, so neither was compared while frozen
+		Test.TestTrue(FString::Printf(TEXT("%s: steps counted"), What), Parallel.GetStepIndex() == NumSteps && Serial.GetStepIndex() == NumSteps);
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBoidsFlockSimulationDeterminismTest, "BoidsCore.FlockSimulation.ParallelMatchesSerial", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FBoidsFlockSimulationDeterminismTest::RunTest(const FString& Parameters)
+{
+	// Wandering draws from the random streams on every step, the part most likely to depend on the order
+	FBoidsSettings Metric;
+	Metric.bApplyCohesion = true;
+	Metric.bApplyWander = true;
+	Metric.WanderWeight = FVector(0.5, 0.5, 0.2);
+
+	FBoidsSettings Topological = Metric;
+	Topological.TopologicalNeighbors = 7;
+
+	FBoidsSettings FarField = Metric;
+	FarField.PerceptionRadius = 1200.0f;
+	FarField.FarFieldRadius = 400.0f;
+
+	bool bSuccess = RunParallelMatchesSerial(*this, TEXT("Metric"), Metric);
+	bSuccess &= RunParallelMatchesSerial(*this, TEXT("Topological"), Topological);
+	bSuccess &= RunParallelMatchesSerial(*this, TEXT("Far field"), FarField);
+	return bSuccess;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBoidsFlockSimulationReplayableTest, "BoidsCore.FlockSimulation.SameSeedSameFlock", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FBoidsFlockSimulationReplayableTest::RunTest(const FString& Parameters)
+{
+	FBoidsSettings Settings;
+	Settings.bApplyWander = true;
+	Settings.WanderWeight = FVector(0.5, 0.5, 0.2);
+
+	// Two runs of the same seed end on the same flock, another seed does not
+	FBoidsFlockSimulation First;
+	FBoidsFlockSimulation Second;
+	FBoidsFlockSimulation Other;
+	InitializeFlock(First, Settings, 500, 42, true);
+	InitializeFlock(Second, Settings, 500, 42, true);
+	InitializeFlock(Other, Settings, 500, 42, true);
+	Other.SetSeed(43);
+
+	for (int32 Step = 0; Step < 30; Step++)
+	{
+		First.Step(1.0f / 60.0f, TConstArrayView<FBoidsAvoidance>());
+		Second.Step(1.0f / 60.0f, TConstArrayView<FBoidsAvoidance>());
+		Other.Step(1.0f / 60.0f, TConstArrayView<FBoidsAvoidance>());
+	}
+
+	TestTrue(TEXT("Same seed, same positions"), FMemory::Memcmp(First.GetState().Positions.GetData(), Second.GetState().Positions.GetData(), 500 * sizeof(FVector)) == 0);
+	TestTrue(TEXT("Other seed, other positions"), FMemory::Memcmp(First.GetState().Positions.GetData(), Other.GetState().Positions.GetData(), 500 * sizeof(FVector)) != 0);
+	return true;
+}
+
+#endif
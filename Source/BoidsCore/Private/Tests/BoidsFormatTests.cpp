@@ -0,0 +1,236 @@
+#include "BoidsFlockSimulation.h"
+#include "BoidsKeyframe.h"
+#include "BoidsQuantization.h"
+#include "BoidsReplay.h"
+#include "BoidsSnapshot.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	// Lowest cosine between a heading and its two byte round trip, about 3.6 degrees
+	constexpr double MinHeadingCosine = 0.998;
+
+	// Flock of NumBoids boids scattered within Extent of Center, the same one for a given seed
+	void FillState(int32 Seed, int32 NumBoids, const FVector& Center, double Extent, FBoidsFlockState& OutState)
+	{
+		FRandomStream Random(Seed);
+		OutState.SetNum(NumBoids);
+		for (int32 i = 0; i < NumBoids; i++)
+		{
+			OutState.Positions[i] = Center + FVector(Random.FRandRange(-Extent, Extent), Random.FRandRange(-Extent, Extent), Random.FRandRange(-Extent, Extent));
+			OutState.Velocities[i] = Random.GetUnitVector() * Random.FRandRange(200.0f, 500.0f);
+		}
+	}
+
+	// Scratch file in the project Saved directory, deleted by the test that asked for it
+	FString MakeTestPath(const TCHAR* Extension)
+	{
+		return FPaths::CreateTempFilename(*FPaths::ProjectSavedDir(), TEXT("BoidsCoreTest"), Extension);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBoidsQuantizationTest, "BoidsCore.Formats.Quantization", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FBoidsQuantizationTest::RunTest(const FString& Parameters)
+{
+	const FVector3f BoxMin(-1200.0f, 300.0f, -50.0f);
+	const FVector3f BoxSize(5000.0f, 2500.0f, 800.0f);
+
+	// Half a quantization step per axis, plus the float rounding of the box
+	const FVector3f MaxError = BoxSize / FBoidsQuantization::PositionSteps * 0.5f + FVector3f(0.01f);
+
+	FRandomStream Random(7);
+	for (int32 i = 0; i < 1000; i++)
+	{
+		const FVector3f Position = BoxMin + FVector3f(Random.FRand(), Random.FRand(), Random.FRand()) * BoxSize;
+		uint16 QuantizedPosition[3];
+		FBoidsQuantization::EncodePosition(Position, BoxMin, BoxSize, QuantizedPosition);
+		const FVector3f Error = (FBoidsQuantization::DecodePosition(QuantizedPosition, BoxMin, BoxSize) - Position).GetAbs();
+		if (!TestTrue(FString::Printf(TEXT("Position %s within half a step"), *Position.ToString()), Error.X <= MaxError.X && Error.Y <= MaxError.Y && Error.Z <= MaxError.Z))
+		{
+			return false;
+		}
+
+		const FVector3f Heading(Random.GetUnitVector());
+		uint8 QuantizedHeading[2];
+		FBoidsQuantization::EncodeHeading(Heading * 350.0f, QuantizedHeading);
+		const FVector3f Decoded = FBoidsQuantization::DecodeHeading(QuantizedHeading);
+		TestTrue(TEXT("Decoded heading is a unit vector"), FMath::IsNearlyEqual(Decoded.Size(), 1.0f, 1.0e-4f));
+		if (!TestTrue(FString::Printf(TEXT("Heading %s round trip"), *Heading.ToString()), FVector3f::DotProduct(Decoded, Heading) >= MinHeadingCosine))
+		{
+			return false;
+		}
+	}
+
+	// Positions outside the box are clamped to its faces
+	uint16 Clamped[3];
+	FBoidsQuantization::EncodePosition(BoxMin - FVector3f(100.0f), BoxMin, BoxSize, Clamped);
+	TestTrue(TEXT("Position below the box clamped to its minimum"), Clamped[0] == 0 && Clamped[1] == 0 && Clamped[2] == 0);
+	FBoidsQuantization::EncodePosition(BoxMin + BoxSize * 2.0f, BoxMin, BoxSize, Clamped);
+	TestTrue(TEXT("Position above the box clamped to its maximum"), Clamped[0] == 65535 && Clamped[1] == 65535 && Clamped[2] == 65535);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBoidsKeyframeTest, "BoidsCore.Formats.Keyframe", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FBoidsKeyframeTest::RunTest(const FString& Parameters)
+{
+	const FVector Origin(1000.0, -2000.0, 300.0);
+	const FVector Extent(4000.0, 4000.0, 2000.0);
+
+	FBoidsFlockState State;
+	FillState(8, 300, Origin, 1500.0, State);
+
+	// A slice starting past the first boid, as the server sends them
+	const int32 FirstBoid = 100;
+	TArray<uint8> Data;
+	FBoidsKeyframe::Encode(State, FirstBoid, 150, Origin, Extent, Data);
+	TestEqual(TEXT("Boids in the slice"), FBoidsKeyframe::GetNumBoids(Data), 150);
+
+	const double MaxError = (Extent * 2.0 / FBoidsQuantization::PositionSteps).GetMax();
+	for (int32 i = 0; i < FBoidsKeyframe::GetNumBoids(Data); i++)
+	{
+		FVector Position;
+		FVector Heading;
+		FBoidsKeyframe::DecodeBoid(Data, i, Origin, Extent, Position, Heading);
+
+		TestEqual(FString::Printf(TEXT("Position of boid %d"), FirstBoid + i), Position, State.Positions[FirstBoid + i], MaxError);
+		TestTrue(FString::Printf(TEXT("Heading of boid %d"), FirstBoid + i), FVector::DotProduct(Heading, State.Velocities[FirstBoid + i].GetSafeNormal()) >= MinHeadingCosine);
+	}
+
+	// A slice running past the flock is cut at its last boid
+	FBoidsKeyframe::Encode(State, 250, 150, Origin, Extent, Data);
+	TestEqual(TEXT("Boids in the last slice"), FBoidsKeyframe::GetNumBoids(Data), 50);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBoidsSnapshotTest, "BoidsCore.Formats.Snapshot", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FBoidsSnapshotTest::RunTest(const FString& Parameters)
+{
+	FBoidsSettings Settings;
+	Settings.PerceptionRadius = 650.0f;
+	Settings.TopologicalNeighbors = 7;
+	Settings.WanderWeight = FVector(0.5, 0.25, 0.1);
+	Settings.bApplyWander = true;
+
+	FBoidsFlockSimulation Saved;
+	Saved.Initialize(Settings, 500);
+	Saved.SetSeed(0xC0FFEE01);
+	FillState(9, 500, FVector::ZeroVector, 3000.0, Saved.GetState());
+	Saved.SetNumActive(420);
+	Saved.SetStepIndex(1234);
+
+	const FString Path = MakeTestPath(TEXT(".boidssnapshot"));
+	if (!TestTrue(TEXT("Snapshot saved"), FBoidsSnapshot::Save(Path, Saved)))
+	{
+		return false;
+	}
+
+	{
+		FBoidsSnapshot Snapshot;
+		if (TestTrue(TEXT("Snapshot opened"), Snapshot.Open(Path)))
+		{
+			TestEqual(TEXT("Boids"), Snapshot.GetNumBoids(), 420);
+			TestTrue(TEXT("Seed"), Snapshot.GetSeed() == Saved.GetSeed());
+			TestEqual(TEXT("Perception radius"), Snapshot.GetSettings().PerceptionRadius, Settings.PerceptionRadius);
+			TestEqual(TEXT("Topological neighbors"), Snapshot.GetSettings().TopologicalNeighbors, Settings.TopologicalNeighbors);
+			TestEqual(TEXT("Wander weight"), Snapshot.GetSettings().WanderWeight, Settings.WanderWeight);
+			TestTrue(TEXT("Wander flag"), Snapshot.GetSettings().bApplyWander);
+
+			FBoidsFlockSimulation Restored;
+			Restored.Initialize(Snapshot.GetSettings(), 500);
+			Snapshot.Restore(Restored);
+
+			TestEqual(TEXT("Active boids"), Restored.GetNumActive(), 420);
+			TestTrue(TEXT("Step index"), Restored.GetStepIndex() == Saved.GetStepIndex());
+
+			// The arrays are stored as in memory, the restored flock is bit identical
+			const FBoidsFlockState& Expected = Saved.GetState();
+			const FBoidsFlockState& Actual = Restored.GetState();
+			TestTrue(TEXT("Positions"), FMemory::Memcmp(Actual.Positions.GetData(), Expected.Positions.GetData(), 420 * sizeof(FVector)) == 0);
+			TestTrue(TEXT("Velocities"), FMemory::Memcmp(Actual.Velocities.GetData(), Expected.Velocities.GetData(), 420 * sizeof(FVector)) == 0);
+		}
+		Snapshot.Close();
+	}
+
+	IFileManager::Get().Delete(*Path);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBoidsReplayTest, "BoidsCore.Formats.Replay", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FBoidsReplayTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumBoids = 200;
+	constexpr int32 NumFrames = 12;
+	constexpr float FrameTime = 1.0f / 30.0f;
+
+	// Every frame has its own flock and active count, so a frame read from the wrong offset shows
+	TArray<FBoidsFlockState> Frames;
+	TArray<int32> NumActive;
+	Frames.SetNum(NumFrames);
+	for (int32 Frame = 0; Frame < NumFrames; Frame++)
+	{
+		FillState(100 + Frame, NumBoids, FVector(Frame * 50.0, 0.0, 0.0), 2000.0, Frames[Frame]);
+		NumActive.Add(NumBoids - Frame * 10);
+	}
+
+	const FString Path = MakeTestPath(TEXT(".boidsreplay"));
+	{
+		FBoidsReplayWriter Writer;
+		if (!TestTrue(TEXT("Replay created"), Writer.Open(Path, NumBoids)))
+		{
+			return false;
+		}
+
+		for (int32 Frame = 0; Frame < NumFrames; Frame++)
+		{
+			Writer.WriteFrame(Frame * FrameTime, Frames[Frame], NumActive[Frame]);
+		}
+		Writer.Close();
+	}
+
+	{
+		FBoidsReplayReader Reader;
+		if (TestTrue(TEXT("Replay opened"), Reader.Open(Path)))
+		{
+			TestEqual(TEXT("Boids"), Reader.GetNumBoids(), NumBoids);
+			TestEqual(TEXT("Frames"), Reader.GetNumFrames(), NumFrames);
+			TestEqual(TEXT("Duration"), Reader.GetDuration(), (NumFrames - 1) * FrameTime);
+
+			// Frames are sampled out of order, each at its own time so nothing is blended
+			FBoidsFlockState Sampled;
+			for (const int32 Frame : { 5, 0, 11, 6, 3 })
+			{
+				const int32 NumSampled = Reader.Sample(Frame * FrameTime, Sampled);
+				TestEqual(FString::Printf(TEXT("Active boids of frame %d"), Frame), NumSampled, NumActive[Frame]);
+
+				// Positions are quantized inside the bounds of the active boids of their frame
+				FBox Bounds(ForceInit);
+				for (int32 i = 0; i < NumActive[Frame]; i++)
+				{
+					Bounds += Frames[Frame].Positions[i];
+				}
+				const double MaxError = Bounds.GetSize().GetMax() / FBoidsQuantization::PositionSteps;
+
+				for (int32 i = 0; i < NumSampled; i++)
+				{
+					TestEqual(FString::Printf(TEXT("Position of boid %d in frame %d"), i, Frame), Sampled.Positions[i], Frames[Frame].Positions[i], MaxError);
+					TestTrue(FString::Printf(TEXT("Heading of boid %d in frame %d"), i, Frame), FVector::DotProduct(Sampled.Velocities[i], Frames[Frame].Velocities[i].GetSafeNormal()) >= MinHeadingCosine);
+				}
+			}
+		}
+	}
+
+	IFileManager::Get().Delete(*Path);
+	return true;
+}
+
+#endif
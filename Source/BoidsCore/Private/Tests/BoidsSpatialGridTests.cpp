@@ -0,0 +1,159 @@
+#include "BoidsSpatialGrid.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	// Points scattered in a box of half size Extent, the same ones for a given seed
+	TArray<FVector> MakePoints(int32 Seed, int32 NumPoints, double Extent)
+	{
+		FRandomStream Random(Seed);
+		TArray<FVector> Points;
+		Points.SetNumUninitialized(NumPoints);
+		for (FVector& Point : Points)
+		{
+			Point = FVector(Random.FRandRange(-Extent, Extent), Random.FRandRange(-Extent, Extent), Random.FRandRange(-Extent, Extent));
+		}
+		return Points;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBoidsSpatialGridRadiusTest, "BoidsCore.SpatialGrid.ForEachInRadius", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FBoidsSpatialGridRadiusTest::RunTest(const FString& Parameters)
+{
+	const TArray<FVector> Points = MakePoints(1, 2000, 3000.0);
+	const TArray<FVector> Centers = MakePoints(2, 50, 3500.0);
+
+	// Radii below, at and above the cell size, the query widens its cell range for the larger ones
+	for (const float Radius : { 250.0f, 500.0f, 1300.0f })
+	{
+		FBoidsSpatialGrid Grid;
+		Grid.Build(Points, 500.0f);
+		TestEqual(TEXT("Indexed points"), Grid.Num(), Points.Num());
+
+		for (const FVector& Center : Centers)
+		{
+			TArray<int32> Found;
+			Grid.ForEachInRadius(Center, Radius, [&Found](int32 Index, const FVector& Position) { Found.Add(Index); });
+
+			TArray<int32> Expected;
+			for (int32 i = 0; i < Points.Num(); i++)
+			{
+				if (FVector::DistSquared(Center, Points[i]) <= FMath::Square(double(Radius)))
+				{
+					Expected.Add(i);
+				}
+			}
+
+			Found.Sort();
+			if (!TestTrue(FString::Printf(TEXT("Points within %.0f of %s"), Radius, *Center.ToString()), Found == Expected))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBoidsSpatialGridNearestTest, "BoidsCore.SpatialGrid.FindNearest", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FBoidsSpatialGridNearestTest::RunTest(const FString& Parameters)
+{
+	const TArray<FVector> Points = MakePoints(3, 2000, 3000.0);
+	const float Radius = 600.0f;
+
+	FBoidsSpatialGrid Grid;
+	Grid.Build(Points, Radius);
+
+	for (const int32 NumNeighbors : { 1, 7, FBoidsNearestNeighbors::MaxCapacity })
+	{
+		for (int32 Query = 0; Query < 100; Query++)
+		{
+			FBoidsNearestNeighbors Nearest;
+			Nearest.Reset(NumNeighbors);
+			Grid.FindNearest(Points[Query], Radius, Query, Nearest);
+
+			// Brute force, every other point within the radius sorted by distance
+			TArray<FBoidsNearestNeighbors::FEntry> Expected;
+			for (int32 i = 0; i < Points.Num(); i++)
+			{
+				const double DistanceSquared = FVector::DistSquared(Points[Query], Points[i]);
+				if (i != Query && DistanceSquared <= FMath::Square(double(Radius)))
+				{
+					Expected.Add({ DistanceSquared, i });
+				}
+			}
+			Expected.Sort([](const FBoidsNearestNeighbors::FEntry& A, const FBoidsNearestNeighbors::FEntry& B) { return A.DistanceSquared < B.DistanceSquared; });
+			Expected.SetNum(FMath::Min(Expected.Num(), NumNeighbors));
+
+			TArray<FBoidsNearestNeighbors::FEntry> Found(Nearest.Entries);
+			Found.Sort([](const FBoidsNearestNeighbors::FEntry& A, const FBoidsNearestNeighbors::FEntry& B) { return A.DistanceSquared < B.DistanceSquared; });
+
+			if (!TestEqual(FString::Printf(TEXT("Neighbors kept for point %d"), Query), Found.Num(), Expected.Num()))
+			{
+				return false;
+			}
+
+			// Distances are compared rather than indices, two points at the same distance may be kept in either order
+			for (int32 i = 0; i < Found.Num(); i++)
+			{
+				TestEqual(FString::Printf(TEXT("Distance of neighbor %d of point %d"), i, Query), Found[i].DistanceSquared, Expected[i].DistanceSquared);
+			}
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBoidsSpatialGridAggregatedTest, "BoidsCore.SpatialGrid.ForEachInRadiusAggregated", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FBoidsSpatialGridAggregatedTest::RunTest(const FString& Parameters)
+{
+	const TArray<FVector> Points = MakePoints(4, 3000, 4000.0);
+	const TArray<FVector> Velocities = MakePoints(5, Points.Num(), 500.0);
+
+	// A radius covering the whole box opens every aggregate, points and aggregates together must add up to every point once
+	const float Radius = 20000.0f;
+	FBoidsSpatialGrid Grid;
+	Grid.Build(Points, 300.0f);
+	Grid.BuildAggregates(Velocities, Radius);
+	TestTrue(TEXT("Aggregates built"), Grid.HasAggregates());
+
+	FBoidsCellAggregate Exact;
+	for (int32 i = 0; i < Points.Num(); i++)
+	{
+		Exact.PositionSum += Points[i];
+		Exact.VelocitySum += Velocities[i];
+		Exact.Num++;
+	}
+
+	for (const FVector& Center : MakePoints(6, 20, 4000.0))
+	{
+		FBoidsCellAggregate Gathered;
+		int32 NumVisitedPoints = 0;
+		Grid.ForEachInRadiusAggregated(Center, Radius,
+			[&Gathered, &NumVisitedPoints, &Velocities](int32 Index, const FVector& Position)
+			{
+				Gathered.PositionSum += Position;
+				Gathered.VelocitySum += Velocities[Index];
+				Gathered.Num++;
+				NumVisitedPoints++;
+			},
+			[&Gathered](const FBoidsCellAggregate& Aggregate)
+			{
+				Gathered.Add(Aggregate);
+			});
+
+		TestEqual(TEXT("Points summed"), Gathered.Num, Exact.Num);
+		TestTrue(TEXT("Some points are read one by one"), NumVisitedPoints > 0);
+		TestEqual(TEXT("Position sum"), Gathered.PositionSum, Exact.PositionSum, 1.0);
+		TestEqual(TEXT("Velocity sum"), Gathered.VelocitySum, Exact.VelocitySum, 1.0);
+	}
+
+	return true;
+}
+
+#endif
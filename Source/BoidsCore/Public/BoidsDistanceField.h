@@ -0,0 +1,45 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * FBoidsDistanceField is a baked 3D grid of distances to the static obstacles
+ * and of their gradients, pointing away from the closest surface.
+ * Samples are stored at the grid nodes Origin + Index * VoxelSize, and
+ * lookups are trilinear so they can run on any thread once baked.
+ */
+struct BOIDSCORE_API FBoidsDistanceField
+{
+	// World position of the first grid node
+	FVector Origin = FVector::ZeroVector;
+
+	// Distance between two grid nodes
+	float VoxelSize = 50.0f;
+
+	// Number of grid nodes on each axis
+	FIntVector Resolution = FIntVector::ZeroValue;
+
+	// Distance to the closest obstacle at each node, negative inside an obstacle
+	TArray<float> Distances;
+
+	// Normalized direction away from the closest obstacle at each node
+	TArray<FVector3f> Gradients;
+
+	// Whether the field holds one sample per grid node
+	bool IsValid() const;
+
+	// Index of a grid node in the sample arrays
+	int32 GetIndex(int32 X, int32 Y, int32 Z) const { return X + Resolution.X * (Y + Resolution.Y * Z); }
+
+	// Allocates the samples for the given grid, every distance set to MaxDistance
+	void Initialize(const FVector& InOrigin, float InVoxelSize, const FIntVector& InResolution, float MaxDistance);
+
+	// Recomputes the gradients from the distances with central differences
+	void ComputeGradients();
+
+	// Trilinear lookup of the field, returns false outside the baked volume
+	bool Sample(const FVector& Position, float& OutDistance, FVector& OutGradient) const;
+
+	// Serializes the grid and its samples
+	friend FArchive& operator<<(FArchive& Ar, FBoidsDistanceField& Field);
+};
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BoidsDistanceField.h"
+#include "BoidsFlockTypes.h"
+#include "BoidsInfluence.h"
+#include "BoidsSpatialGrid.h"
+#include "BoidsSteeringKernel.h"
+
+/**
+ * FBoidsFlockSimulation steps a whole flock in one pass.
+ * It owns the flock state and the spatial grid used for neighbor queries,
+ * and applies the same rules as ABoids::Tick to every boid.
+ * The state is double buffered: a step reads the previous frame and writes
+ * the next one, so boids can be stepped in parallel and in any order.
+ * Each boid draws from its own counter-based random stream, so a step only
+ * depends on the seed, the previous state and its inputs.
+ * The state is sized once for the whole pool, only the active boids at its
+ * start are simulated, so the population changes without any allocation.
+ */
+class BOIDSCORE_API FBoidsFlockSimulation
+{
+public:
+	// Sizes the flock state for NumBoids boids with the given settings, every boid starts active
+	void Initialize(const FBoidsSettings& Settings, int32 NumBoids);
+
+	// Number of boids simulated, the first NumActive of the state, the others are pooled and left untouched
+	void SetNumActive(int32 NumActive);
+	int32 GetNumActive() const { return m_NumActive; }
+
+	// Places a pooled boid in both state buffers and clears its tier, before it is activated
+	void ResetBoid(int32 Index, const FVector& Position, const FVector& Velocity);
+
+	// Rebuilds the spatial grid from the current positions
+	void RebuildGrid();
+
+	// Advances every boid by DeltaTime, Avoidance holds one entry per boid or is empty
+	void Step(float DeltaTime, TConstArrayView<FBoidsAvoidance> Avoidance);
+
+	// Whether Step spreads the boid chunks over the task graph workers
+	void SetParallel(bool bParallel) { m_bParallel = bParallel; }
+
+	// Baked obstacle field sampled by every boid instead of the avoidance input, may be null
+	void SetDistanceField(const FBoidsDistanceField* DistanceField) { m_DistanceField = DistanceField; }
+
+	// Whether obstacles are avoided through a baked field
+	bool HasDistanceField() const { return m_DistanceField != nullptr; }
+	const FBoidsDistanceField* GetDistanceField() const { return m_DistanceField; }
+
+	// Attractors and repulsors applied from the next step on
+	void SetInfluences(TConstArrayView<FBoidsInfluence> Sources) { m_Influences.SetSources(Sources); }
+
+	// Splits the step time between neighbor search and steering, costs two clock reads per boid
+	void SetPhaseTimings(bool bPhaseTimings) { m_bPhaseTimings = bPhaseTimings; }
+
+	// Timings of the last step, the whole step counts as steering unless phase timings are enabled
+	const FBoidsStepTimings& GetLastStepTimings() const { return m_LastStepTimings; }
+
+	// Update rates of the mid and far tiers
+	void SetLodSettings(const FBoidsLodSettings& LodSettings) { m_LodSettings = LodSettings; }
+
+	// Simulation tier of each boid, every boid is near until set otherwise
+	TArrayView<EBoidsLod> GetLods() { return m_Lods; }
+	TConstArrayView<EBoidsLod> GetLods() const { return m_Lods; }
+
+	// Seed of the per boid random streams
+	void SetSeed(uint32 Seed) { m_Seed = Seed; }
+	uint32 GetSeed() const { return m_Seed; }
+
+	// Number of steps run so far, restored with a snapshot so the random streams carry on
+	uint32 GetStepIndex() const { return m_StepIndex; }
+	void SetStepIndex(uint32 StepIndex) { m_StepIndex = StepIndex; }
+
+	// Time a step may spend on the rules, due boids left past it are extrapolated and stepped first next time, zero for no limit
+	// A budget makes the result depend on the machine speed, leave it at zero for reproducible runs
+	void SetStepBudget(double Seconds) { m_StepBudgetSeconds = Seconds; }
+
+	// Whether the boid at Index reads its avoidance input on the step numbered StepIndex, GetStepIndex() being the next one
+	bool NeedsAvoidance(int32 Index, uint32 StepIndex) const;
+
+	// Steering parameters of the flock
+	const FBoidsSettings& GetSettings() const { return m_Settings; }
+
+	// Current flock state, one entry per boid
+	FBoidsFlockState& GetState() { return m_States[m_CurrentState]; }
+	const FBoidsFlockState& GetState() const { return m_States[m_CurrentState]; }
+
+	// Flock state before the last step, used to interpolate between two steps
+	const FBoidsFlockState& GetPreviousState() const { return m_States[1 - m_CurrentState]; }
+
+	// Copies the current state over the previous one, so a flock set from outside does not interpolate from stale data
+	void CopyStateToPrevious();
+
+	// Spatial grid built from the flock positions
+	const FBoidsSpatialGrid& GetGrid() const { return m_Grid; }
+
+	// Whether distant neighbors are read from the grid aggregates, the far field only applies to metric neighborhoods
+	static bool UsesFarField(const FBoidsSettings& Settings);
+
+	// Cell size of the neighbor grid, the far field radius when distant neighbors are aggregated
+	static float GetGridCellSize(const FBoidsSettings& Settings);
+
+	// Appends the neighbors of the point at Index to Neighbors, from Grid built over Positions with GetGridCellSize
+	static void GatherGridNeighbors(const FBoidsSpatialGrid& Grid, const FBoidsSettings& Settings, int32 Index, TConstArrayView<FVector> Positions, TConstArrayView<FVector> Velocities, FBoidsNeighborBuffer& Neighbors);
+
+private:
+	// Whether the boid at Index with the given tier runs the rules on the step numbered StepIndex
+	bool IsSteppedAt(int32 Index, EBoidsLod Lod, uint32 StepIndex) const;
+
+	// Fills Neighbors with the neighbors of one boid of Previous, far boids only sample their own cell
+	void GatherNeighbors(int32 Index, EBoidsLod Lod, const FBoidsFlockState& Previous, FBoidsNeighborBuffer& Neighbors) const;
+
+	// Applies every rule to one boid of Previous from its gathered Neighbors and writes the integrated boid to Next
+	void StepBoid(int32 Index, float DeltaTime, EBoidsLod Lod, const FBoidsAvoidance& AvoidanceInput, const FBoidsFlockState& Previous, FBoidsFlockState& Next, FBoidsNeighborBuffer& Neighbors) const;
+
+	// Steering parameters of the flock
+	FBoidsSettings m_Settings;
+
+	// Previous and next flock states, one entry per boid
+	FBoidsFlockState m_States[2];
+
+	// Index of the current state in m_States
+	int32 m_CurrentState = 0;
+
+	// Number of simulated boids at the start of the state
+	int32 m_NumActive = 0;
+
+	// Simulation tier of each boid
+	TArray<EBoidsLod> m_Lods;
+
+	// Update rates of the mid and far tiers
+	FBoidsLodSettings m_LodSettings;
+
+	// Number of steps run so far, staggers the reduced tiers over the frames and keys the random streams
+	uint32 m_StepIndex = 0;
+
+	// Seed of the per boid random streams
+	uint32 m_Seed = 0;
+
+	// Time a step may spend on the rules, zero for no limit
+	double m_StepBudgetSeconds = 0.0;
+
+	// Whether each boid was due on a previous step but deferred past the budget
+	TArray<bool> m_Pending;
+
+	// Chunk the next step starts from, moves round-robin over the deferred chunks
+	int32 m_ChunkCursor = 0;
+
+	// Spatial grid built from the current positions
+	FBoidsSpatialGrid m_Grid;
+
+	// Whether Step spreads the boid chunks over the task graph workers
+	bool m_bParallel = true;
+
+	// Baked obstacle field, not owned
+	const FBoidsDistanceField* m_DistanceField = nullptr;
+
+	// Attractors and repulsors, evaluated once per step through the grid
+	FBoidsInfluenceField m_Influences;
+
+	// Whether the step time is split between neighbor search and steering
+	bool m_bPhaseTimings = false;
+
+	// Timings of the last step
+	FBoidsStepTimings m_LastStepTimings;
+};
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * FBoidsSettings holds the steering parameters shared by every boid of a flock.
+ * Default values match the ABoids defaults.
+ */
+struct FBoidsSettings
+{
+	// Maximum speed of a boid
+	float MaxSpeed = 500.0f;
+
+	// Minimum speed of a boid
+	float MinSpeed = 200.0f;
+
+	// Perception radius for detecting neighbors
+	float PerceptionRadius = 500.0f;
+
+	// Weight for alignment behavior
+	float AlignmentWeight = 1.0f;
+
+	// Weight for cohesion behavior
+	float CohesionWeight = 1.0f;
+
+	// Weight for separation behavior
+	float SeparationWeight = 1.0f;
+
+	// Radius for separation behavior
+	float SeparationRadius = 150.0f;
+
+	// Number of nearest neighbors a boid reacts to, zero reacts to every neighbor within the perception radius
+	int32 TopologicalNeighbors = 0;
+
+	// Distance beyond which neighbors are read from cell aggregates instead of one by one, zero or the perception radius sums every neighbor exactly
+	float FarFieldRadius = 0.0f;
+
+	// Weight for obstacle avoidance behavior
+	float AvoidanceWeight = 1.0f;
+
+	// Weight for wandering behavior
+	FVector WanderWeight = FVector::ZeroVector;
+
+	// Whether the cohesion rule is applied before integration
+	bool bApplyCohesion = false;
+
+	// Whether the wander rule is applied before integration
+	bool bApplyWander = false;
+
+	// Whether a step moves the boid once after every rule instead of once before and once after the steering forces
+	bool bSingleIntegration = false;
+};
+
+/**
+ * FBoidsAvoidance is the obstacle avoidance input of one boid for a step,
+ * gathered by the owner of the simulation from its scene queries.
+ */
+struct FBoidsAvoidance
+{
+	// Number of avoidance rays cast per boid and step
+	static constexpr int32 NumRays = 5;
+
+	// Yaw of each avoidance ray relative to the heading, each direction is cast once
+	static constexpr float RayYaws[NumRays] = { 0.0f, -15.0f, 15.0f, -30.0f, 30.0f };
+
+	// Length of the avoidance rays
+	static constexpr float RayLength = 200.0f;
+
+	// Sum of the weighted hit normals used to steer away before integration
+	FVector Steer = FVector::ZeroVector;
+
+	// Normalized avoidance force added to the steering forces
+	FVector Force = FVector::ZeroVector;
+
+	// Whether any obstacle was detected
+	bool bDetected = false;
+
+	// Accumulates the hit of ray RayIndex cast from Start
+	void AddHit(int32 RayIndex, const FVector& Start, const FVector& ImpactPoint, float Weight)
+	{
+		const FVector AvoidanceVector = Start - ImpactPoint;
+		const float Ratio = 1.0f - (AvoidanceVector.Size() / RayLength);
+		const FVector Normal = AvoidanceVector.GetSafeNormal();
+
+		Steer += Normal * Ratio * Weight;
+		bDetected = true;
+
+		// The steering force only uses the forward and widest rays
+		if (RayIndex == 0 || RayIndex >= 3)
+		{
+			Force += Normal * Ratio * Ratio;
+		}
+	}
+
+	// Accumulates a distance field sample, Gradient points away from the closest obstacle
+	void AddFieldSample(float Distance, const FVector& Gradient, float Weight)
+	{
+		if (Distance >= RayLength || Gradient.IsNearlyZero())
+		{
+			return;
+		}
+
+		const float Ratio = 1.0f - (FMath::Max(Distance, 0.0f) / RayLength);
+
+		Steer += Gradient * Ratio * Weight;
+		Force += Gradient * Ratio * Ratio;
+		bDetected = true;
+	}
+
+	// Normalizes the force once every hit is added
+	void Finalize()
+	{
+		Force = Force.GetSafeNormal();
+	}
+};
+
+/**
+ * EBoidsLod is the simulation level of detail of one boid, picked from its distance to the viewers.
+ */
+enum class EBoidsLod : uint8
+{
+	// Stepped every frame with every rule
+	Near,
+
+	// Stepped every few frames, extrapolated in between
+	Mid,
+
+	// Stepped every few frames without obstacle avoidance, from a few neighbors of its own cell
+	Far,
+
+	// Frozen far from every viewer, neither stepped nor extrapolated, still seen by its neighbors
+	Asleep
+};
+
+/**
+ * FBoidsLodSettings holds the update rates of the reduced simulation tiers.
+ */
+struct FBoidsLodSettings
+{
+	// Frames between two steps of a mid boid
+	int32 MidInterval = 2;
+
+	// Frames between two steps of a far boid
+	int32 FarInterval = 4;
+
+	// Neighbors sampled by a far boid
+	int32 FarMaxNeighbors = 8;
+};
+
+/**
+ * FBoidsFlockState stores the flock in contiguous arrays, one entry per boid.
+ */
+struct FBoidsFlockState
+{
+	// World position of each boid
+	TArray<FVector> Positions;
+
+	// Velocity of each boid
+	TArray<FVector> Velocities;
+
+	// Number of boids in the state
+	int32 Num() const { return Positions.Num(); }
+
+	// Resizes every array to NumBoids entries
+	void SetNum(int32 NumBoids)
+	{
+		Positions.SetNumZeroed(NumBoids);
+		Velocities.SetNumZeroed(NumBoids);
+	}
+};
+
+/**
+ * FBoidsStepTimings splits the wall time of one simulation step by phase.
+ */
+struct FBoidsStepTimings
+{
+	// Spatial grid rebuild and neighbor gathering, in seconds
+	double NeighborSearchSeconds = 0.0;
+
+	// Rule evaluation and integration, in seconds
+	double SteeringSeconds = 0.0;
+};
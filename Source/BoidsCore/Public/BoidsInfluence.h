@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BoidsSpatialGrid.h"
+
+/**
+ * FBoidsInfluence is a point or sphere attractor or repulsor acting on every
+ * boid within its radius. The force is full inside the inner radius and
+ * falls off to zero at the outer one.
+ */
+struct FBoidsInfluence
+{
+	// World center of the source
+	FVector Position = FVector::ZeroVector;
+
+	// Radius under which the force is full, zero for a point source
+	float InnerRadius = 0.0f;
+
+	// Radius beyond which the source has no effect
+	float Radius = 1000.0f;
+
+	// Force at full effect, positive attracts and negative repels
+	float Strength = 1000.0f;
+
+	// Exponent of the falloff between the two radii, one is linear
+	float Falloff = 1.0f;
+
+	// Force applied by the source on a boid at BoidPosition
+	FVector GetForce(const FVector& BoidPosition) const
+	{
+		const FVector ToSource = Position - BoidPosition;
+		const double Distance = ToSource.Size();
+		if (Distance >= Radius || Distance <= UE_KINDA_SMALL_NUMBER)
+		{
+			return FVector::ZeroVector;
+		}
+
+		const float Ratio = Radius > InnerRadius ? FMath::Clamp(float((Radius - Distance) / (Radius - InnerRadius)), 0.0f, 1.0f) : 1.0f;
+		return ToSource / Distance * Strength * FMath::Pow(Ratio, Falloff);
+	}
+};
+
+/**
+ * FBoidsInfluenceField sums the influence sources on the boids of a flock.
+ * Each source visits the boids within its radius through the flock grid,
+ * so the cost grows with the affected boids rather than boids times sources.
+ */
+class BOIDSCORE_API FBoidsInfluenceField
+{
+public:
+	// Replaces every source
+	void SetSources(TConstArrayView<FBoidsInfluence> Sources) { m_Sources.Reset(Sources.Num()); m_Sources.Append(Sources.GetData(), Sources.Num()); }
+
+	// Number of sources
+	int32 GetNumSources() const { return m_Sources.Num(); }
+
+	// Sums the force of every source on the boids of Grid, built over NumBoids positions
+	void Evaluate(const FBoidsSpatialGrid& Grid, int32 NumBoids);
+
+	// Summed force on the boid at Index by the last evaluation
+	FVector GetForce(int32 Index) const { return m_Forces.IsValidIndex(Index) ? m_Forces[Index] : FVector::ZeroVector; }
+
+private:
+	// Influence sources
+	TArray<FBoidsInfluence> m_Sources;
+
+	// Summed force on each boid, zero for the boids out of reach
+	TArray<FVector> m_Forces;
+
+	// Boids given a force by the last evaluation, cleared by the next one instead of the whole array
+	TArray<int32> m_Influenced;
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BoidsFlockTypes.h"
+
+/**
+ * FBoidsKeyframe encodes the active boids of a flock for the network, 8 bytes
+ * per boid: the position as three 16 bit offsets inside a fixed box around
+ * the manager, so both ends agree on it without sending it, and the heading
+ * as two octahedral bytes. Speeds are not sent, the receiver keeps its own.
+ */
+struct BOIDSCORE_API FBoidsKeyframe
+{
+	// Bytes per boid
+	static constexpr int32 BoidSize = 8;
+
+	// Writes NumBoids boids of State from FirstBoid on to OutData, positions are taken within Extent of Origin
+	static void Encode(const FBoidsFlockState& State, int32 FirstBoid, int32 NumBoids, const FVector& Origin, const FVector& Extent, TArray<uint8>& OutData);
+
+	// Number of boids held by Data
+	static int32 GetNumBoids(TConstArrayView<uint8> Data) { return Data.Num() / BoidSize; }
+
+	// Decodes the boid at Index of Data, OutHeading is a unit vector
+	static void DecodeBoid(TConstArrayView<uint8> Data, int32 Index, const FVector& Origin, const FVector& Extent, FVector& OutPosition, FVector& OutHeading);
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * FBoidsQuantization packs boid positions and headings into a few bytes,
+ * shared by the replay files and the network keyframes.
+ * Positions are 16 bit offsets inside a box, headings are unit vectors
+ * folded on the octahedron and stored as two bytes.
+ */
+struct FBoidsQuantization
+{
+	// Largest value of a quantized position axis
+	static constexpr float PositionSteps = 65535.0f;
+
+	// Largest value of a quantized heading axis
+	static constexpr float HeadingSteps = 255.0f;
+
+	// Quantizes the position of Position inside the box starting at BoxMin of size BoxSize, positions outside are clamped
+	static void EncodePosition(const FVector3f& Position, const FVector3f& BoxMin, const FVector3f& BoxSize, uint16 OutQuantized[3])
+	{
+		const FVector3f Scale(
+			BoxSize.X > 0.0f ? PositionSteps / BoxSize.X : 0.0f,
+			BoxSize.Y > 0.0f ? PositionSteps / BoxSize.Y : 0.0f,
+			BoxSize.Z > 0.0f ? PositionSteps / BoxSize.Z : 0.0f
+		);
+		const FVector3f Offset = (Position - BoxMin) * Scale;
+
+		OutQuantized[0] = uint16(FMath::Clamp(FMath::RoundToInt32(Offset.X), 0, 65535));
+		OutQuantized[1] = uint16(FMath::Clamp(FMath::RoundToInt32(Offset.Y), 0, 65535));
+		OutQuantized[2] = uint16(FMath::Clamp(FMath::RoundToInt32(Offset.Z), 0, 65535));
+	}
+
+	// Inverse of EncodePosition
+	static FVector3f DecodePosition(const uint16 Quantized[3], const FVector3f& BoxMin, const FVector3f& BoxSize)
+	{
+		return BoxMin + FVector3f(Quantized[0], Quantized[1], Quantized[2]) / PositionSteps * BoxSize;
+	}
+
+	// Quantizes the direction of Heading to two bytes, a zero heading decodes as straight up
+	static void EncodeHeading(const FVector3f& Heading, uint8 OutQuantized[2])
+	{
+		const FVector2f Encoded = EncodeOctahedron(Heading.GetSafeNormal());
+		OutQuantized[0] = uint8(FMath::RoundToInt32((Encoded.X * 0.5f + 0.5f) * HeadingSteps));
+		OutQuantized[1] = uint8(FMath::RoundToInt32((Encoded.Y * 0.5f + 0.5f) * HeadingSteps));
+	}
+
+	// Inverse of EncodeHeading, returns a unit vector
+	static FVector3f DecodeHeading(const uint8 Quantized[2])
+	{
+		return DecodeOctahedron(FVector2f(Quantized[0] / HeadingSteps * 2.0f - 1.0f, Quantized[1] / HeadingSteps * 2.0f - 1.0f));
+	}
+
+	// Maps a unit vector to the octahedron unfolded on the [-1, 1] square
+	static FVector2f EncodeOctahedron(const FVector3f& Direction)
+	{
+		const FVector3f Projected = Direction / FMath::Max(FMath::Abs(Direction.X) + FMath::Abs(Direction.Y) + FMath::Abs(Direction.Z), UE_SMALL_NUMBER);
+		if (Projected.Z >= 0.0f)
+		{
+			return FVector2f(Projected.X, Projected.Y);
+		}
+
+		return FVector2f(
+			(1.0f - FMath::Abs(Projected.Y)) * (Projected.X >= 0.0f ? 1.0f : -1.0f),
+			(1.0f - FMath::Abs(Projected.X)) * (Projected.Y >= 0.0f ? 1.0f : -1.0f)
+		);
+	}
+
+	// Inverse of EncodeOctahedron
+	static FVector3f DecodeOctahedron(const FVector2f& Encoded)
+	{
+		FVector3f Direction(Encoded.X, Encoded.Y, 1.0f - FMath::Abs(Encoded.X) - FMath::Abs(Encoded.Y));
+		if (Direction.Z < 0.0f)
+		{
+			const float X = Direction.X;
+			Direction.X = (1.0f - FMath::Abs(Direction.Y)) * (X >= 0.0f ? 1.0f : -1.0f);
+			Direction.Y = (1.0f - FMath::Abs(X)) * (Direction.Y >= 0.0f ? 1.0f : -1.0f);
+		}
+
+		return Direction.GetSafeNormal();
+	}
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * FBoidsRandom is a counter-based random generator for one boid and one step.
+ * Every draw hashes the flock seed, the boid index, the step index and a draw
+ * counter, so a boid gets the same numbers whatever worker steps it and in
+ * whatever order, and no state is shared between boids.
+ */
+struct FBoidsRandom
+{
+	// Stream of the boid at BoidIndex for the step at StepIndex of a flock seeded with Seed
+	FBoidsRandom(uint32 Seed, uint32 BoidIndex, uint32 StepIndex)
+		: m_Key(Mix((uint64(Seed) << 32) | BoidIndex) ^ Mix(0x9E3779B97F4A7C15ull * (uint64(StepIndex) + 1)))
+	{
+	}
+
+	// Uniform value in [0, 1)
+	float FRand()
+	{
+		// The top 24 bits fill the float mantissa exactly
+		return float(Mix(m_Key + 0xD1B54A32D192ED03ull * ++m_Counter) >> 40) * (1.0f / 16777216.0f);
+	}
+
+	// Uniform value in [Min, Max)
+	float FRandRange(float Min, float Max)
+	{
+		return Min + (Max - Min) * FRand();
+	}
+
+	// Uniform direction on the unit sphere
+	FVector GetUnitVector()
+	{
+		const float Z = FRandRange(-1.0f, 1.0f);
+		const float Angle = FRandRange(0.0f, UE_TWO_PI);
+		const float Radius = FMath::Sqrt(FMath::Max(1.0f - Z * Z, 0.0f));
+		return FVector(Radius * FMath::Cos(Angle), Radius * FMath::Sin(Angle), Z);
+	}
+
+private:
+	// SplitMix64 finalizer
+	static uint64 Mix(uint64 Value)
+	{
+		Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+		Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+		return Value ^ (Value >> 31);
+	}
+
+	// Hash of the seed, boid and step
+	uint64 m_Key;
+
+	// Number of values drawn so far
+	uint32 m_Counter = 0;
+};
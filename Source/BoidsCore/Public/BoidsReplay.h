@@ -0,0 +1,128 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BoidsFlockTypes.h"
+
+class IFileHandle;
+
+/**
+ * Boid replays store one frame per simulation step: the time of the step, the
+ * bounds of the flock, the number of active boids, then every boid of the pool
+ * quantized to 8 bytes, pooled boids being left zeroed, its position as
+ * three 16 bit offsets inside the bounds and its heading as two octahedral bytes.
+ * Frames all have the same size, so any frame is found without an index.
+ */
+struct FBoidsReplayFormat
+{
+	// Identifies a boid replay file
+	static constexpr uint32 Magic = 0x4C505242;
+
+	// Bumped whenever the layout changes
+	static constexpr uint32 Version = 2;
+
+	// Bytes before the first frame: magic, version, boid count and frame count
+	static constexpr int64 HeaderSize = 16;
+
+	// Offset of the frame count in the header, patched when the recording ends
+	static constexpr int64 NumFramesOffset = 12;
+
+	// Bytes before the boids of a frame: time, bounds minimum, bounds size and active boid count
+	static constexpr int64 FrameHeaderSize = 32;
+
+	// Bytes per boid and frame
+	static constexpr int64 BoidSize = 8;
+
+	// Bytes of a whole frame of NumBoids boids
+	static int64 GetFrameSize(int32 NumBoids) { return FrameHeaderSize + BoidSize * NumBoids; }
+};
+
+/**
+ * FBoidsReplayWriter streams the flock state of every step to a replay file.
+ */
+class BOIDSCORE_API FBoidsReplayWriter
+{
+public:
+	// Closes the file if it is still open
+	~FBoidsReplayWriter();
+
+	// Creates the replay file at Path for a pool of NumBoids boids
+	bool Open(const FString& Path, int32 NumBoids);
+
+	// Appends the flock state reached at Time, in seconds since the recording started, of which the first NumActive boids are alive
+	void WriteFrame(float Time, const FBoidsFlockState& State, int32 NumActive);
+
+	// Writes the frame count and closes the file
+	void Close();
+
+	// Whether a recording is in progress
+	bool IsOpen() const { return m_Archive.IsValid(); }
+
+private:
+	// Replay file being written
+	TUniquePtr<FArchive> m_Archive;
+
+	// Number of boids of every frame
+	int32 m_NumBoids = 0;
+
+	// Number of frames written so far
+	int32 m_NumFrames = 0;
+
+	// Encoded frame, reused between frames
+	TArray<uint8> m_FrameBuffer;
+};
+
+/**
+ * FBoidsReplayReader streams a replay file and decodes the flock at any time,
+ * blending the two recorded frames around it. Only the frame headers stay in
+ * memory, the boids of the two blended frames are read from the file on demand.
+ */
+class BOIDSCORE_API FBoidsReplayReader
+{
+public:
+	// Closes the file if it is still open
+	~FBoidsReplayReader();
+
+	// Opens the replay file at Path and reads its frame headers
+	bool Open(const FString& Path);
+
+	// Number of boids of every frame, the size of the recorded pool
+	int32 GetNumBoids() const { return m_NumBoids; }
+
+	// Number of recorded frames
+	int32 GetNumFrames() const { return m_FrameTimes.Num(); }
+
+	// Time of the last frame
+	float GetDuration() const { return m_FrameTimes.Num() > 0 ? m_FrameTimes.Last() : 0.0f; }
+
+	// Fills the positions and headings of OutState at Time, velocities are unit headings, returns the number of active boids
+	int32 Sample(float Time, FBoidsFlockState& OutState);
+
+private:
+	// Reads the active boids of Frame into its buffer, unless they are there already, returns whether they could be read
+	bool LoadFrame(int32 Frame);
+
+	// Decodes one boid of a loaded frame
+	void DecodeBoid(int32 Frame, int32 Boid, FVector& OutPosition, FVector& OutHeading) const;
+
+	// Replay file being read
+	TUniquePtr<IFileHandle> m_File;
+
+	// Boids of the last two loaded frames, odd frames in the second buffer so a frame and the next never evict each other
+	TArray<uint8> m_FrameBuffers[2];
+
+	// Frame held by each buffer, INDEX_NONE when empty
+	int32 m_LoadedFrames[2] = { INDEX_NONE, INDEX_NONE };
+
+	// Number of boids of every frame
+	int32 m_NumBoids = 0;
+
+	// Time of each frame
+	TArray<float> m_FrameTimes;
+
+	// Bounds minimum and size of each frame
+	TArray<FVector3f> m_FrameBoundsMin;
+	TArray<FVector3f> m_FrameBoundsSize;
+
+	// Number of active boids of each frame
+	TArray<int32> m_FrameNumActive;
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BoidsFlockTypes.h"
+#include "BoidsRandom.h"
+#include "BoidsSteeringKernel.h"
+
+/**
+ * FBoidsRules applies the flocking rules to one boid from its neighbor sums:
+ * separation, obstacle avoidance, alignment, optional cohesion and wander,
+ * then the weighted steering forces, and integrates the result.
+ */
+struct BOIDSCORE_API FBoidsRules
+{
+	// Distance under which the separation rule pushes neighbors away before integration
+	static constexpr float SeparationDistance = 100.0f;
+
+	// Accumulates the neighbor sums of one boid, pads Neighbors for the steering kernel
+	static FBoidsSteeringSums GatherSums(FBoidsNeighborBuffer& Neighbors, const FBoidsSettings& Settings);
+
+	// Applies every rule and integrates Position and Velocity over DeltaTime
+	static void Integrate(const FBoidsSettings& Settings, const FBoidsSteeringSums& Sums, const FBoidsAvoidance& Avoidance, FBoidsRandom& Random, float DeltaTime, FVector& Position, FVector& Velocity);
+
+	// Moves Position along Velocity by the same distance Integrate would over DeltaTime, without applying any rule
+	static void Extrapolate(const FBoidsSettings& Settings, float DeltaTime, const FVector& Velocity, FVector& Position);
+};
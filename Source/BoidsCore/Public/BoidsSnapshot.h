@@ -0,0 +1,109 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BoidsFlockTypes.h"
+
+class FBoidsFlockSimulation;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * FBoidsSnapshotHeader starts every flock snapshot file. It is followed by the
+ * positions then the velocities of every boid, stored exactly as in memory and
+ * aligned so both arrays can be read in place from a mapped file.
+ */
+struct FBoidsSnapshotHeader
+{
+	// Identifies a flock snapshot file
+	static constexpr uint32 FileMagic = 0x534E4642;
+
+	// Bumped whenever the layout changes
+	static constexpr uint32 FileVersion = 3;
+
+	// Alignment of the header and of both arrays
+	static constexpr int64 Alignment = 16;
+
+	// Bits of Flags
+	static constexpr uint32 ApplyCohesionFlag = 1 << 0;
+	static constexpr uint32 ApplyWanderFlag = 1 << 1;
+	static constexpr uint32 SingleIntegrationFlag = 1 << 2;
+
+	uint32 Magic = FileMagic;
+	uint32 Version = FileVersion;
+	int32 NumBoids = 0;
+	uint32 Seed = 0;
+	uint32 StepIndex = 0;
+	uint32 Flags = 0;
+
+	float MaxSpeed = 0.0f;
+	float MinSpeed = 0.0f;
+	float PerceptionRadius = 0.0f;
+	float AlignmentWeight = 0.0f;
+	float CohesionWeight = 0.0f;
+	float SeparationWeight = 0.0f;
+	float SeparationRadius = 0.0f;
+	float AvoidanceWeight = 0.0f;
+	int32 TopologicalNeighbors = 0;
+	float FarFieldRadius = 0.0f;
+	double WanderWeight[3] = { 0.0, 0.0, 0.0 };
+
+	// Offsets of the position and velocity arrays from the start of the file
+	int64 PositionsOffset = 0;
+	int64 VelocitiesOffset = 0;
+};
+
+/**
+ * FBoidsSnapshot saves a settled flock to a flat binary file and maps it back,
+ * so a level can start from a pre-settled flock instead of a random spawn.
+ * Restoring copies each array in one block, no boid is deserialized on its own.
+ */
+class BOIDSCORE_API FBoidsSnapshot
+{
+public:
+	// Writes the settings and current state of Simulation to Path
+	static bool Save(const FString& Path, const FBoidsFlockSimulation& Simulation);
+
+	// Releases the mapped file
+	~FBoidsSnapshot();
+
+	// Maps the snapshot at Path, reads it in memory where the platform cannot map files
+	bool Open(const FString& Path);
+
+	// Releases the mapped file
+	void Close();
+
+	// Whether a valid snapshot is open
+	bool IsOpen() const { return m_Data != nullptr; }
+
+	// Number of boids in the snapshot
+	int32 GetNumBoids() const { return m_Header.NumBoids; }
+
+	// Steering parameters saved with the flock
+	FBoidsSettings GetSettings() const;
+
+	// Seed of the saved simulation
+	uint32 GetSeed() const { return m_Header.Seed; }
+
+	// Positions of every boid, read in place
+	TConstArrayView<FVector> GetPositions() const;
+
+	// Restores the state, active count and step index into Simulation, initialized beforehand for at least GetNumBoids() boids
+	void Restore(FBoidsFlockSimulation& Simulation) const;
+
+private:
+	// Checks the header and points m_Data at Data
+	bool SetData(const uint8* Data, int64 Size, const FString& Path);
+
+	// Copy of the header of the open snapshot
+	FBoidsSnapshotHeader m_Header;
+
+	// Start of the open snapshot, mapped or loaded
+	const uint8* m_Data = nullptr;
+
+	// Mapped snapshot file and region
+	TUniquePtr<IMappedFileHandle> m_MappedFile;
+	TUniquePtr<IMappedFileRegion> m_MappedRegion;
+
+	// Snapshot content when the platform cannot map files
+	TArray<uint8> m_LoadedData;
+};
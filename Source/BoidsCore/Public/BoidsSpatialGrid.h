@@ -0,0 +1,289 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * FBoidsNearestNeighbors keeps the k closest points offered to it in a fixed
+ * inline buffer ordered as a max heap, so the farthest kept point is evicted in
+ * O(log k) and a query never allocates however dense the flock gets.
+ */
+struct FBoidsNearestNeighbors
+{
+	// Largest number of neighbors a query can keep
+	static constexpr int32 MaxCapacity = 16;
+
+	struct FEntry
+	{
+		// Squared distance to the query point
+		double DistanceSquared;
+
+		// Index of the point
+		int32 Index;
+	};
+
+	// Kept points, the farthest one on top of the heap
+	TArray<FEntry, TFixedAllocator<MaxCapacity>> Entries;
+
+	// Number of points kept at most
+	int32 Capacity = 0;
+
+	// Removes every point and sets how many are kept, clamped to MaxCapacity
+	void Reset(int32 InCapacity)
+	{
+		Entries.Reset();
+		Capacity = FMath::Clamp(InCapacity, 0, MaxCapacity);
+	}
+
+	// Keeps the point if it is among the Capacity closest offered so far
+	void Offer(int32 Index, double DistanceSquared)
+	{
+		const auto FartherFirst = [](const FEntry& A, const FEntry& B) { return A.DistanceSquared > B.DistanceSquared; };
+
+		if (Entries.Num() < Capacity)
+		{
+			Entries.HeapPush(FEntry{ DistanceSquared, Index }, FartherFirst);
+		}
+		else if (Capacity > 0 && DistanceSquared < Entries.HeapTop().DistanceSquared)
+		{
+			Entries.HeapPopDiscard(FartherFirst, EAllowShrinking::No);
+			Entries.HeapPush(FEntry{ DistanceSquared, Index }, FartherFirst);
+		}
+	}
+};
+
+/**
+ * FBoidsCellAggregate sums the points of one cell of the aggregate hierarchy,
+ * enough to stand for all of them in the alignment and cohesion rules.
+ */
+struct FBoidsCellAggregate
+{
+	// Sum of the point positions
+	FVector PositionSum = FVector::ZeroVector;
+
+	// Sum of the point velocities
+	FVector VelocitySum = FVector::ZeroVector;
+
+	// Sum of the point headings
+	FVector HeadingSum = FVector::ZeroVector;
+
+	// Number of points summed
+	int32 Num = 0;
+
+	// Mean position of the points
+	FVector GetCenterOfMass() const { return Num > 0 ? PositionSum / Num : FVector::ZeroVector; }
+
+	// Adds the sums of a child cell
+	void Add(const FBoidsCellAggregate& Other)
+	{
+		PositionSum += Other.PositionSum;
+		VelocitySum += Other.VelocitySum;
+		HeadingSum += Other.HeadingSum;
+		Num += Other.Num;
+	}
+};
+
+/**
+ * FBoidsSpatialGrid is a uniform spatial hash used for boid neighbor queries.
+ * It is rebuilt once per frame from the flock positions and stores the boid
+ * indices sorted by cell, so a query only visits the cells around a point
+ * instead of every boid in the world.
+ * It can also sum its cells into a hierarchy of aggregates, each level twice as
+ * coarse as the one below, for Barnes-Hut style far-field queries.
+ */
+class BOIDSCORE_API FBoidsSpatialGrid
+{
+public:
+	// Rebuilds the grid from the given positions, cells are CellSize wide
+	void Build(TConstArrayView<FVector> Positions, float CellSize);
+
+	// Clears every cell and indexed position
+	void Reset();
+
+	// Calls Visit(Index, Position) for every indexed point within Radius of Center
+	template <typename FunctorType>
+	void ForEachInRadius(const FVector& Center, float Radius, FunctorType&& Visit) const;
+
+	// Calls Visit(Index, Position) for every indexed point in the cell containing Center, stops once Visit returns false
+	template <typename FunctorType>
+	void ForEachInCell(const FVector& Center, FunctorType&& Visit) const;
+
+	// Keeps in Nearest the points within Radius of Center closest to it, ExcludeIndex left out, Nearest sets how many
+	void FindNearest(const FVector& Center, float Radius, int32 ExcludeIndex, FBoidsNearestNeighbors& Nearest) const;
+
+	// Sums the cells of the last build into enough aggregate levels for queries of Radius, Velocities indexed like the built positions
+	void BuildAggregates(TConstArrayView<FVector> Velocities, float Radius);
+
+	// Whether the last build has aggregates
+	bool HasAggregates() const { return m_NumAggregateLevels > 0; }
+
+	// Calls VisitPoint(Index, Position) for the points within Radius in the cells around Center and VisitAggregate(Aggregate)
+	// for the farther aggregates whose center of mass is within Radius, each point is visited once either way
+	template <typename PointFunctorType, typename AggregateFunctorType>
+	void ForEachInRadiusAggregated(const FVector& Center, float Radius, PointFunctorType&& VisitPoint, AggregateFunctorType&& VisitAggregate) const;
+
+	// Returns the cell coordinates containing the given position
+	FIntVector GetCell(const FVector& Position) const;
+
+	// Size of a cell edge
+	float GetCellSize() const { return m_CellSize; }
+
+	// Number of indexed points
+	int32 Num() const { return m_SortedIndices.Num(); }
+
+private:
+	// First sorted slot and number of points for each occupied cell
+	TMap<FIntVector, FIntPoint> m_Cells;
+
+	// Point indices sorted by cell
+	TArray<int32> m_SortedIndices;
+
+	// Point positions sorted by cell, kept next to the indices for cache friendly queries
+	TArray<FVector> m_SortedPositions;
+
+	// Cell of each point, scratch buffer reused between builds
+	TArray<FIntVector> m_PointCells;
+
+	// Size of a cell edge
+	float m_CellSize = 500.0f;
+
+	// Inverse of the cell size
+	float m_InvCellSize = 1.0f / 500.0f;
+
+	// Aggregates of each level, level zero sums the grid cells, the maps are kept between builds
+	TArray<TMap<FIntVector, FBoidsCellAggregate>> m_AggregateLevels;
+
+	// Number of levels built for the current grid, zero without aggregates
+	int32 m_NumAggregateLevels = 0;
+
+	// Coordinates at Level of the aggregate containing the grid cell Cell
+	static FIntVector GetParentCell(const FIntVector& Cell, int32 Level) { return FIntVector(Cell.X >> Level, Cell.Y >> Level, Cell.Z >> Level); }
+};
+
+template <typename FunctorType>
+void FBoidsSpatialGrid::ForEachInRadius(const FVector& Center, float Radius, FunctorType&& Visit) const
+{
+	if (m_Cells.Num() == 0)
+	{
+		return;
+	}
+
+	// With cells sized to the perception radius this only visits the 27 surrounding cells
+	const int32 Range = FMath::Max(1, FMath::CeilToInt32(Radius * m_InvCellSize));
+	const FIntVector CenterCell = GetCell(Center);
+	const double RadiusSquared = FMath::Square(Radius);
+
+	for (int32 X = -Range; X <= Range; X++)
+	{
+		for (int32 Y = -Range; Y <= Range; Y++)
+		{
+			for (int32 Z = -Range; Z <= Range; Z++)
+			{
+				const FIntPoint* Cell = m_Cells.Find(CenterCell + FIntVector(X, Y, Z));
+				if (!Cell)
+				{
+					continue;
+				}
+
+				const int32 End = Cell->X + Cell->Y;
+				for (int32 Slot = Cell->X; Slot < End; Slot++)
+				{
+					if (FVector::DistSquared(Center, m_SortedPositions[Slot]) <= RadiusSquared)
+					{
+						Visit(m_SortedIndices[Slot], m_SortedPositions[Slot]);
+					}
+				}
+			}
+		}
+	}
+}
+
+template <typename FunctorType>
+void FBoidsSpatialGrid::ForEachInCell(const FVector& Center, FunctorType&& Visit) const
+{
+	const FIntPoint* Cell = m_Cells.Find(GetCell(Center));
+	if (!Cell)
+	{
+		return;
+	}
+
+	const int32 End = Cell->X + Cell->Y;
+	for (int32 Slot = Cell->X; Slot < End; Slot++)
+	{
+		if (!Visit(m_SortedIndices[Slot], m_SortedPositions[Slot]))
+		{
+			return;
+		}
+	}
+}
+
+template <typename PointFunctorType, typename AggregateFunctorType>
+void FBoidsSpatialGrid::ForEachInRadiusAggregated(const FVector& Center, float Radius, PointFunctorType&& VisitPoint, AggregateFunctorType&& VisitAggregate) const
+{
+	if (m_NumAggregateLevels == 0)
+	{
+		ForEachInRadius(Center, Radius, VisitPoint);
+		return;
+	}
+
+	const FIntVector CenterCell = GetCell(Center);
+	const double RadiusSquared = FMath::Square(Radius);
+
+	// The top level is at least Radius wide, the 27 aggregates around Center cover the whole query
+	const int32 TopLevel = m_NumAggregateLevels - 1;
+	const FIntVector TopCell = GetParentCell(CenterCell, TopLevel);
+
+	TArray<TPair<int32, FIntVector>, TInlineAllocator<64>> Pending;
+	for (int32 X = -1; X <= 1; X++)
+	{
+		for (int32 Y = -1; Y <= 1; Y++)
+		{
+			for (int32 Z = -1; Z <= 1; Z++)
+			{
+				Pending.Emplace(TopLevel, TopCell + FIntVector(X, Y, Z));
+			}
+		}
+	}
+
+	while (Pending.Num() > 0)
+	{
+		const TPair<int32, FIntVector> Node = Pending.Pop(EAllowShrinking::No);
+		const int32 Level = Node.Key;
+
+		const FBoidsCellAggregate* Aggregate = m_AggregateLevels[Level].Find(Node.Value);
+		if (!Aggregate)
+		{
+			continue;
+		}
+
+		// Aggregates that do not touch the one holding Center are far enough to stand for their points
+		const FIntVector Delta = Node.Value - GetParentCell(CenterCell, Level);
+		if (FMath::Abs(Delta.X) > 1 || FMath::Abs(Delta.Y) > 1 || FMath::Abs(Delta.Z) > 1)
+		{
+			if (FVector::DistSquared(Center, Aggregate->GetCenterOfMass()) <= RadiusSquared)
+			{
+				VisitAggregate(*Aggregate);
+			}
+			continue;
+		}
+
+		// Close aggregates are opened, down to the points of the grid cells around Center
+		if (Level > 0)
+		{
+			for (int32 Child = 0; Child < 8; Child++)
+			{
+				Pending.Emplace(Level - 1, Node.Value * 2 + FIntVector(Child & 1, (Child >> 1) & 1, (Child >> 2) & 1));
+			}
+			continue;
+		}
+
+		const FIntPoint& Cell = m_Cells.FindChecked(Node.Value);
+		const int32 End = Cell.X + Cell.Y;
+		for (int32 Slot = Cell.X; Slot < End; Slot++)
+		{
+			if (FVector::DistSquared(Center, m_SortedPositions[Slot]) <= RadiusSquared)
+			{
+				VisitPoint(m_SortedIndices[Slot], m_SortedPositions[Slot]);
+			}
+		}
+	}
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CountersTrace.h"
+
+// Shown with `stat boids`
+DECLARE_STATS_GROUP(TEXT("Boids"), STATGROUP_Boids, STATCAT_Advanced);
+
+// Phases of the batch step and of the boid actor tick
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Grid Build"), STAT_BoidsGridBuild, STATGROUP_Boids, BOIDSCORE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Simulation Step"), STAT_BoidsStep, STATGROUP_Boids, BOIDSCORE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Step Chunk"), STAT_BoidsStepChunk, STATGROUP_Boids, BOIDSCORE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Find Neighbors"), STAT_BoidsFindNeighbors, STATGROUP_Boids, BOIDSCORE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Steering"), STAT_BoidsSteering, STATGROUP_Boids, BOIDSCORE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Obstacle Avoidance"), STAT_BoidsObstacleAvoidance, STATGROUP_Boids, BOIDSCORE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Move"), STAT_BoidsMove, STATGROUP_Boids, BOIDSCORE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Write Back"), STAT_BoidsWriteBack, STATGROUP_Boids, BOIDSCORE_API);
+
+// Per frame counters, average and max neighbors are only known to the batch step
+// The neighbor total is 64 bits wide, it grows with the square of a dense flock
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Boids"), STAT_BoidsNum, STATGROUP_Boids, BOIDSCORE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Boids Stepped"), STAT_BoidsStepped, STATGROUP_Boids, BOIDSCORE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Boids Deferred"), STAT_BoidsDeferred, STATGROUP_Boids, BOIDSCORE_API);
+DECLARE_QWORD_COUNTER_STAT_EXTERN(TEXT("Neighbors"), STAT_BoidsNeighbors, STATGROUP_Boids, BOIDSCORE_API);
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Average Neighbors"), STAT_BoidsAverageNeighbors, STATGROUP_Boids, BOIDSCORE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Max Neighbors"), STAT_BoidsMaxNeighbors, STATGROUP_Boids, BOIDSCORE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Traces Issued"), STAT_BoidsTracesIssued, STATGROUP_Boids, BOIDSCORE_API);
+
+// Insights channel of the boid pipeline, enabled with -trace=cpu,boids
+UE_TRACE_CHANNEL_EXTERN(BoidsChannel, BOIDSCORE_API);
+
+// Scopes a phase both for `stat boids` and as a CPU event on the Boids trace channel
+#define BOIDS_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Stat, BoidsChannel)
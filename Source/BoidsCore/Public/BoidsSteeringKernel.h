@@ -0,0 +1,75 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * FBoidsSteeringSums holds every accumulator needed by the separation,
+ * alignment and cohesion rules, computed in a single pass over the neighbors.
+ */
+struct FBoidsSteeringSums
+{
+	// Sum of the separation vectors weighted by distance, for neighbors closer than the near radius
+	FVector NearSeparation = FVector::ZeroVector;
+
+	// Sum of the separation vectors weighted by distance, for neighbors closer than the far radius
+	FVector FarSeparation = FVector::ZeroVector;
+
+	// Sum of the neighbor headings
+	FVector Heading = FVector::ZeroVector;
+
+	// Sum of the neighbor velocities
+	FVector Velocity = FVector::ZeroVector;
+
+	// Sum of the offsets to the neighbors
+	FVector Offset = FVector::ZeroVector;
+
+	// Number of neighbors accumulated
+	int32 Num = 0;
+
+	// Sum of the attractor and repulsor forces reaching the boid, added to the steering forces as is
+	FVector Influence = FVector::ZeroVector;
+};
+
+/**
+ * FBoidsNeighborBuffer stores the neighbors of one boid as structure of arrays.
+ * Offsets are relative to the boid so they fit in single precision lanes,
+ * and every array is padded with zero entries to a multiple of the SIMD width.
+ * Far neighbors can also be given as ready-made sums, added after the kernel pass.
+ */
+struct BOIDSCORE_API FBoidsNeighborBuffer
+{
+	// Offset from the boid to each neighbor
+	TArray<float> OffsetX;
+	TArray<float> OffsetY;
+	TArray<float> OffsetZ;
+
+	// Velocity of each neighbor
+	TArray<float> VelocityX;
+	TArray<float> VelocityY;
+	TArray<float> VelocityZ;
+
+	// Number of neighbors, without the padding
+	int32 Num = 0;
+
+	// Sums of the neighbors read from cell aggregates instead of one by one
+	FBoidsSteeringSums FarField;
+
+	// Removes every neighbor and the far-field sums, keeping the allocations
+	void Reset();
+
+	// Appends a neighbor
+	void Add(const FVector& Offset, const FVector& Velocity);
+
+	// Pads the arrays with zero entries up to the SIMD width
+	void Pad();
+};
+
+/**
+ * FBoidsSteeringKernel computes the steering accumulators of one boid
+ * four neighbors at a time with VectorRegister4Float.
+ */
+struct BOIDSCORE_API FBoidsSteeringKernel
+{
+	// Accumulates the rule sums over a padded neighbor buffer
+	static FBoidsSteeringSums Accumulate(const FBoidsNeighborBuffer& Neighbors, float NearRadius, float FarRadius);
+};